@@ -0,0 +1,86 @@
+#include <chrono>
+#include <string>
+#include <cstdio>
+#include <Core/Format/Json.hpp>
+#define BENCHMARK_COUNT_HEAP
+#include "Benchmark.hpp"
+
+// Counts the global allocations made while parsing and destroying a document
+// with the std containers, with std::pmr containers on the heap and in an arena
+
+template <typename J>
+using type = Core::DefaultStrategy<J, std::string, double, int64_t, bool, std::nullptr_t>;
+
+template <typename J>
+using pmrtype = Core::DefaultStrategy<J, std::pmr::string, double, int64_t, bool, std::nullptr_t>;
+
+using Json = Core::Json<std::string, type>;
+using PmrJson = Core::Json<std::pmr::string, pmrtype, std::pmr::map, std::pmr::vector>;
+
+std::string Message()
+{
+    std::string Result = "{\"Messages\":[";
+
+    for (std::size_t i = 0; Result.size() < 200 * 1024; ++i)
+    {
+        Result += i ? "," : "";
+        Result += "{\"Id\":" + std::to_string(i) + ",\"From\":\"sender number " + std::to_string(i) +
+                  " with a name long enough to leave the small string buffer\",\"Score\":0.5,\"Tags\":[\"a\",\"b\"],\"Read\":false}";
+    }
+
+    return Result + "]}";
+}
+
+template <typename F>
+void Report(char const *Name, F &&Function, std::size_t Size)
+{
+    constexpr std::size_t Iterations = 50;
+
+    std::size_t Before = HeapAllocations;
+    auto Start = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < Iterations; ++i)
+        Function();
+
+    double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+    std::printf("%-28s %10zu heap allocations per document  %8.1f MB/s parse + release\n",
+                Name, (HeapAllocations - Before) / Iterations, Size * Iterations / Seconds / 1e6);
+}
+
+int main(int, char const *[])
+{
+    auto Input = Message();
+
+    std::printf("%zu bytes\n", Input.size());
+
+    Report("std containers", [&]
+           { Json::From(Input); },
+           Input.size());
+
+    Report("pmr containers, heap", [&]
+           { PmrJson::From(Input); },
+           Input.size());
+
+    Report("pmr containers, Arena", [&]
+           {
+               Core::Arena Memory{Input.size() * 4};
+               PmrJson::From(Input, &Memory); },
+           Input.size());
+
+    Report("Document (arena, no dtors)", [&]
+           { Core::Document<PmrJson> Parsed{Input}; },
+           Input.size());
+
+    Core::CountingResource Counter;
+    Core::Arena Memory{4096, &Counter};
+
+    {
+        auto Parsed = PmrJson::From(Input, &Memory);
+    }
+
+    std::printf("Arena served %zu allocations (%zu bytes) from %zu upstream allocations\n",
+                Memory.Allocations(), Memory.BytesAllocated(), Counter.Allocations());
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+
+// Helpers shared by the benchmarks. Defining BENCHMARK_COUNT_HEAP before including this file
+// replaces the global operator new and delete with ones adding up the allocations made to
+// HeapAllocations and HeapBytes, which a single source file per executable may do.
+
+// Time Function takes per call averaged over Iterations calls, in seconds unless TPeriod says
+// otherwise
+
+template <typename TPeriod = std::ratio<1>, typename F>
+double Measure(F &&Function, std::size_t Iterations = 1)
+{
+    auto Start = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < Iterations; ++i)
+        Function();
+
+    return std::chrono::duration<double, TPeriod>(std::chrono::steady_clock::now() - Start).count() / Iterations;
+}
+
+inline std::atomic<std::size_t> HeapAllocations = 0;
+inline std::atomic<std::size_t> HeapBytes = 0;
+
+#ifdef BENCHMARK_COUNT_HEAP
+
+void *operator new(std::size_t Size)
+{
+    HeapAllocations.fetch_add(1, std::memory_order_relaxed);
+    HeapBytes.fetch_add(Size, std::memory_order_relaxed);
+
+    if (void *Pointer = std::malloc(Size ? Size : 1))
+        return Pointer;
+
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t Size, std::align_val_t Alignment)
+{
+    auto Align = static_cast<std::size_t>(Alignment);
+
+    HeapAllocations.fetch_add(1, std::memory_order_relaxed);
+    HeapBytes.fetch_add(Size, std::memory_order_relaxed);
+
+    if (void *Pointer = std::aligned_alloc(Align, (Size + Align - 1) & ~(Align - 1)))
+        return Pointer;
+
+    throw std::bad_alloc();
+}
+
+// Not inlined, GCC would otherwise see std::free called on what operator new returned and warn
+// about mismatched functions
+
+[[gnu::noinline]] void operator delete(void *Pointer) noexcept
+{
+    std::free(Pointer);
+}
+
+void operator delete(void *Pointer, std::size_t) noexcept
+{
+    ::operator delete(Pointer);
+}
+
+void operator delete(void *Pointer, std::align_val_t) noexcept
+{
+    ::operator delete(Pointer);
+}
+
+void operator delete(void *Pointer, std::size_t, std::align_val_t) noexcept
+{
+    ::operator delete(Pointer);
+}
+
+#endif
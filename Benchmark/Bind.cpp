@@ -0,0 +1,161 @@
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <optional>
+#include <Core/Format/Json.hpp>
+#include <Core/Format/Json/Bind.hpp>
+#include <Core/Format/Json/Writer.hpp>
+#include "Benchmark.hpp"
+
+// Filling structs out of a tree by hand against binding them straight from the input
+
+template <typename J>
+using type = Core::DefaultStrategy<J, std::string, double, int64_t, bool, std::nullptr_t>;
+
+using Json = Core::Json<std::string, type>;
+
+struct Item
+{
+    std::int64_t Id = 0;
+    std::string Name;
+    double Price = 0;
+    std::optional<std::int64_t> Discount;
+    std::vector<std::string> Tags;
+};
+
+struct Order
+{
+    std::string Customer;
+    std::vector<Item> Items;
+};
+
+template <>
+struct Core::Describe<Item>
+{
+    constexpr static std::tuple Fields{Core::Field{"Id", &Item::Id}, Core::Field{"Name", &Item::Name}, Core::Field{"Price", &Item::Price},
+                                       Core::Field{"Discount", &Item::Discount}, Core::Field{"Tags", &Item::Tags}};
+};
+
+template <>
+struct Core::Describe<Order>
+{
+    constexpr static std::tuple Fields{Core::Field{"Customer", &Order::Customer}, Core::Field{"Items", &Order::Items}};
+};
+
+// Numbers have to follow the Json grammar, the ones too small for their member round to zero
+
+struct Reading
+{
+    std::int64_t X = 0;
+    double Y = 0;
+    float Z = 0;
+};
+
+template <>
+struct Core::Describe<Reading>
+{
+    constexpr static std::tuple Fields{Core::Field{"X", &Reading::X}, Core::Field{"Y", &Reading::Y}, Core::Field{"Z", &Reading::Z}};
+};
+
+bool Numbers()
+{
+    for (std::string_view Rejected : {R"({"X": nan, "Y": 1})", R"({"X": 007, "Y": 1})", R"({"X": 1, "Y": inf})", R"({"X": 1, "Y": -nan})",
+                                      R"({"X": 1, "Y": 01.5})", R"({"X": 1.5})", R"({"X": 1e2})", R"({"Y": 1e400})", R"({"Z": 1e50})", R"({"Y": .5})"})
+    {
+        if (Reading Out; Core::Bind::Parse(Rejected, Out))
+        {
+            std::printf("bound %.*s\n", static_cast<int>(Rejected.size()), Rejected.data());
+            return false;
+        }
+    }
+
+    Reading Out{1, 1, 1};
+
+    if (!Core::Bind::Parse(R"({"X": -0, "Y": 1e-400, "Z": -1e-50})", Out) || Out.X != 0 || Out.Y != 0 || Out.Z != 0 || !std::signbit(Out.Z))
+    {
+        std::printf("underflow mismatch\n");
+        return false;
+    }
+
+    return Core::Bind::Parse(R"({"X": -12, "Y": 2.5e-3, "Z": 1e-40})", Out) && Out.X == -12 && Out.Y == 2.5e-3 && Out.Z == 1e-40f;
+}
+
+std::string Input()
+{
+    std::string Result = "{\"Customer\":\"someone\",\"Items\":[";
+
+    for (std::size_t i = 0; Result.size() < 1024 * 1024; ++i)
+    {
+        Result += i ? "," : "";
+        Result += "{\"Id\":" + std::to_string(i) + ",\"Name\":\"item " + std::to_string(i) + "\",\"Price\":" +
+                  std::to_string(i % 500) + ".5,\"Discount\":" + (i % 3 ? std::to_string(i % 30) : "null") +
+                  ",\"Tags\":[\"one\",\"two\"],\"Unused\":{\"Note\":\"skipped\"}}";
+    }
+
+    return Result + "]}";
+}
+
+Order FromTree(Json &Object)
+{
+    Order Result;
+
+    Result.Customer = Object["Customer"].As<std::string>();
+
+    for (auto &Entry : Object["Items"].As<Json::Array>())
+    {
+        auto &Fields = Entry.As<Json>();
+        auto &Added = Result.Items.emplace_back();
+
+        Added.Id = Fields["Id"].As<std::int64_t>();
+        Added.Name = Fields["Name"].As<std::string>();
+        Added.Price = Fields["Price"].As<double>();
+
+        if (Fields["Discount"].Is<std::int64_t>())
+            Added.Discount = Fields["Discount"].As<std::int64_t>();
+
+        for (auto &Tag : Fields["Tags"].As<Json::Array>())
+            Added.Tags.push_back(Tag.As<std::string>());
+    }
+
+    return Result;
+}
+
+int main(int, char const *[])
+{
+    if (!Numbers())
+        return 1;
+
+    auto Text = Input();
+
+    std::size_t Count = 0;
+
+    double Tree = Measure([&]
+                          {
+                              auto Object = Json::From(Text);
+                              Count = FromTree(Object).Items.size(); },
+                          20);
+
+    double Bound = Measure([&]
+                           {
+                               Order Result;
+                               Core::Bind::Parse(Text, Result);
+                               Count = Result.Items.size(); },
+                           20);
+
+    Order Parsed;
+    Core::Bind::Parse(Text, Parsed);
+
+    std::size_t Size = 0;
+
+    double Written = Measure([&]
+                             { Size = Core::Serialize(Parsed).size(); },
+                             20);
+
+    std::printf("%zu bytes, %zu items\n", Text.size(), Count);
+    std::printf("tree + As chains  %8.1f MB/s\n", Text.size() / Tree / 1e6);
+    std::printf("Bind::Parse       %8.1f MB/s  %.1fx\n", Text.size() / Bound / 1e6, Tree / Bound);
+    std::printf("Serialize         %8.1f MB/s\n", Size / Written / 1e6);
+
+    return 0;
+}
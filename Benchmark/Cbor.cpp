@@ -0,0 +1,161 @@
+#include <string>
+#include <cstdio>
+#include <limits>
+#include <sstream>
+#include <Core/Format/Json.hpp>
+#include <Core/Format/Json/Cbor.hpp>
+#include <Core/Format/Json/Writer.hpp>
+#include "Benchmark.hpp"
+
+// Size and throughput of CBOR against text for the same document, both ways, with owned
+// strings and with views into the input. Round trips are checked to give the document back.
+
+template <typename J>
+using type = Core::DefaultStrategy<J, std::string, double, int64_t, bool, std::nullptr_t>;
+
+template <typename J>
+using viewtype = Core::DefaultStrategy<J, std::string_view, double, int64_t, bool, std::nullptr_t>;
+
+using Json = Core::Json<std::string, type>;
+using ViewJson = Core::Json<std::string_view, viewtype>;
+
+// Counts the events, to measure the parsers apart from building the tree
+
+struct Counter
+{
+    std::size_t Events = 0;
+
+    void StartObject() { ++Events; }
+    void EndObject() { ++Events; }
+    void StartArray() { ++Events; }
+    void EndArray() { ++Events; }
+    void Key(std::string_view) { ++Events; }
+    void String(std::string_view) { ++Events; }
+    void Integer(std::int64_t) { ++Events; }
+    void Double(double) { ++Events; }
+    void Boolean(bool) { ++Events; }
+    void Null() { ++Events; }
+};
+
+// Keeps the last double read, the others only being counted
+
+struct Reader : Counter
+{
+    double Value = 0;
+
+    void Double(double Read) { Value = Read; }
+};
+
+// Doubles a float holds exactly are written as one, the others, those beyond the range of a
+// float among them, keep all of their 8 bytes
+
+bool Floats()
+{
+    constexpr double Infinity = std::numeric_limits<double>::infinity();
+
+    for (auto [Value, Size] : {std::pair{1.5, 5}, {-0.0, 5}, {Infinity, 5}, {-Infinity, 5}, {0.1, 9}, {1e39, 9},
+                               {-1e300, 9}, {std::numeric_limits<double>::max(), 9}, {double(std::numeric_limits<float>::max()), 5}})
+    {
+        auto Binary = Core::Cbor::Encode(Value);
+
+        Reader Read;
+        Core::Cbor::Parse(Binary, Read);
+
+        if (Binary.size() != std::size_t(Size) || Read.Value != Value)
+        {
+            std::printf("%g written in %zu bytes, read back as %g\n", Value, Binary.size(), Read.Value);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::string Response()
+{
+    std::string Result = "{\"Status\":\"ok\",\"Results\":[";
+
+    for (std::size_t i = 0; Result.size() < 1024 * 1024; ++i)
+    {
+        Result += i ? "," : "";
+        Result += "{\"Id\":" + std::to_string(i * 7919) + ",\"Name\":\"result " + std::to_string(i) +
+                  "\",\"Score\":" + std::to_string(i % 1000) + ".125,\"Ratio\":0.3333333333333333,\"Tags\":[\"alpha\",\"beta\"],\"Visible\":true,\"Owner\":null}";
+    }
+
+    return Result + "]}";
+}
+
+int main(int, char const *[])
+{
+    if (!Floats())
+        return 1;
+
+    auto Text = Response();
+    auto Object = Json::From(Text);
+    auto Binary = Core::Cbor::Encode(Object);
+
+    std::printf("%zu bytes of text, %zu bytes of CBOR\n", Text.size(), Binary.size());
+
+    if (!(Core::Cbor::From<Json>(Binary) == Object) || Core::Serialize(Core::Cbor::From<ViewJson>(Binary)) != Core::Serialize(Object))
+    {
+        std::printf("round trip mismatch\n");
+        return 1;
+    }
+
+    // Throughputs are counted in the size of the document as text for all of them
+
+    double Stream = Measure([&]
+                            {
+                                std::stringstream Output;
+                                Output << Object; },
+                            20);
+
+    double Written = Measure([&]
+                             { Core::Serialize(Object); },
+                             20);
+
+    double Encoded = Measure([&]
+                             { Core::Cbor::Encode(Object); },
+                             20);
+
+    std::printf("encode  operator<<      %8.1f MB/s\n", Text.size() / Stream / 1e6);
+    std::printf("encode  Serialize       %8.1f MB/s\n", Text.size() / Written / 1e6);
+    std::printf("encode  Cbor::Encode    %8.1f MB/s  %.1fx over operator<<, %.1fx over Serialize\n",
+                Text.size() / Encoded / 1e6, Stream / Encoded, Written / Encoded);
+
+    Counter Events;
+
+    double Scanned = Measure([&]
+                             { Core::Sax::Parse(Text, Events); },
+                             20);
+
+    double Walked = Measure([&]
+                            { Core::Cbor::Parse(Binary, Events); },
+                            20);
+
+    std::printf("events  Sax::Parse      %8.1f MB/s\n", Text.size() / Scanned / 1e6);
+    std::printf("events  Cbor::Parse     %8.1f MB/s  %.1fx\n", Text.size() / Walked / 1e6, Scanned / Walked);
+
+    double Parsed = Measure([&]
+                            { Json::From(Text); },
+                            20);
+
+    double Decoded = Measure([&]
+                             { Core::Cbor::From<Json>(Binary); },
+                             20);
+
+    double ParsedViews = Measure([&]
+                                 { ViewJson::From(Text); },
+                                 20);
+
+    double DecodedViews = Measure([&]
+                                  { Core::Cbor::From<ViewJson>(Binary); },
+                                  20);
+
+    std::printf("decode  Json::From      %8.1f MB/s\n", Text.size() / Parsed / 1e6);
+    std::printf("decode  Cbor::From      %8.1f MB/s  %.1fx\n", Text.size() / Decoded / 1e6, Parsed / Decoded);
+    std::printf("views   Json::From      %8.1f MB/s\n", Text.size() / ParsedViews / 1e6);
+    std::printf("views   Cbor::From      %8.1f MB/s  %.1fx\n", Text.size() / DecodedViews / 1e6, ParsedViews / DecodedViews);
+
+    return 0;
+}
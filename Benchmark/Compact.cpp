@@ -0,0 +1,131 @@
+#include <string>
+#include <cstdio>
+#include <Core/Format/Json.hpp>
+#include <Core/Format/Json/Compact.hpp>
+#include <Core/Format/Json/Writer.hpp>
+#include "Benchmark.hpp"
+
+// Memory per element and speed of CompactStrategy against DefaultStrategy, on a document
+// of number heavy arrays and on one of records with short strings. Every byte the tree
+// allocates goes through a CountingResource, the storages being the std::pmr ones.
+
+template <typename J>
+using type = Core::DefaultStrategy<J, std::pmr::string, double, int64_t, bool, std::nullptr_t>;
+
+template <typename J>
+using compacttype = Core::CompactStrategy<J, std::pmr::string, double, int64_t, bool, std::nullptr_t>;
+
+using Json = Core::Json<std::pmr::string, type, std::pmr::map, std::pmr::vector>;
+using CompactJson = Core::Json<std::pmr::string, compacttype, std::pmr::map, std::pmr::vector>;
+
+std::string Numbers(std::size_t Rows, std::size_t Width)
+{
+    std::string Result = "{\"Rows\":[";
+
+    for (std::size_t i = 0; i < Rows; ++i)
+    {
+        Result += i ? ",[" : "[";
+
+        for (std::size_t k = 0; k < Width; ++k)
+            Result += (k ? "," : "") + (k % 2 ? std::to_string(i * k) : std::to_string(i * k) + ".5");
+
+        Result += "]";
+    }
+
+    return Result + "]}";
+}
+
+std::string Records(std::size_t Count)
+{
+    std::string Result = "{\"Rows\":[";
+
+    for (std::size_t i = 0; i < Count; ++i)
+    {
+        Result += i ? "," : "";
+        Result += "{\"Id\":" + std::to_string(i) + ",\"Name\":\"user" + std::to_string(i % 1000) +
+                  "\",\"Country\":\"NL\",\"Score\":" + std::to_string(i % 100) + ".25,\"Active\":true,\"Parent\":null}";
+    }
+
+    return Result + "]}";
+}
+
+// Counts the leaves of a tree, visiting every element
+
+template <typename TValue>
+std::size_t Leaves(TValue const &Value, double &Sum)
+{
+    return Value.Visit(
+        [&](auto const &Item) -> std::size_t
+        {
+            using TItem = std::decay_t<decltype(Item)>;
+
+            std::size_t Count = 0;
+
+            if constexpr (std::is_same_v<TItem, typename TValue::Array>)
+            {
+                for (auto const &Element : Item)
+                    Count += Leaves(Element, Sum);
+            }
+            else if constexpr (std::is_same_v<TItem, typename TValue::Json>)
+            {
+                for (auto const &[Key, Element] : Item.GetMap())
+                    Count += Leaves(Element, Sum);
+            }
+            else
+            {
+                if constexpr (std::is_arithmetic_v<TItem>)
+                    Sum += Item;
+
+                Count = 1;
+            }
+
+            return Count; });
+}
+
+template <typename J>
+void Run(char const *Name, std::string const &Input)
+{
+    Core::CountingResource Counter;
+
+    auto Object = J::From(Input, &Counter);
+
+    double Sum = 0;
+    std::size_t Count = Leaves(Object["Rows"], Sum);
+
+    double Parse = Measure<std::nano>([&]
+                                      { J::From(Input); },
+                                      5);
+
+    double Iterate = Measure<std::nano>([&]
+                                        { Leaves(Object["Rows"], Sum); },
+                                        20) /
+                     Count;
+
+    std::printf("%-8s %8zu leaves  value %2zu bytes  %6.1f bytes/leaf  parse %7.1f MB/s  iterate %5.2f ns/leaf  (%g)\n",
+                Name, Count, sizeof(typename J::Value), static_cast<double>(Counter.BytesAllocated()) / Count,
+                Input.size() / Parse * 1e3, Iterate, Sum);
+}
+
+int main(int, char const *[])
+{
+    auto Table = Numbers(20000, 32);
+    auto Users = Records(100000);
+
+    std::printf("numbers, %zu bytes\n", Table.size());
+
+    Run<Json>("Default", Table);
+    Run<CompactJson>("Compact", Table);
+
+    std::printf("records, %zu bytes\n", Users.size());
+
+    Run<Json>("Default", Users);
+    Run<CompactJson>("Compact", Users);
+
+    if (Core::Serialize(Json::From(Users)) != Core::Serialize(CompactJson::From(Users)))
+    {
+        std::printf("mismatch\n");
+        return 1;
+    }
+
+    return 0;
+}
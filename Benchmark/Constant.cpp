@@ -0,0 +1,81 @@
+#include <string>
+#include <cstdio>
+#include <Core/Format/Json.hpp>
+#include <Core/Format/Json/Constant.hpp>
+#include "Benchmark.hpp"
+
+// Reading settings out of a document parsed while compiling against one parsed at startup.
+// The checks below run while compiling, a malformed literal failing them instead of the build.
+
+template <typename J>
+using type = Core::DefaultStrategy<J, std::string, double, int64_t, bool, std::nullptr_t>;
+
+using Json = Core::Json<std::string, type>;
+
+constexpr auto &Defaults = Core::Constant::From<STRINGIFY({
+    "Server" : {"Host" : "localhost", "Port" : 8080, "Secure" : false},
+    "Limits" : [ 0, -12, 1.5, 2.5e-3, -1e-400, 123456789012345678901 ],
+    "Tags" : [],
+    "Owner" : null
+})>;
+
+static_assert(Defaults["Server"]["Host"].As<std::string_view>() == "localhost");
+static_assert(Defaults["Server"]["Port"].As<std::int64_t>() == 8080);
+static_assert(!Defaults["Server"]["Secure"].As<bool>());
+static_assert(Defaults["Server"].As<Core::Constant::Object>().Size() == 3);
+static_assert(Defaults["Limits"].As<Core::Constant::Array>().Size() == 6);
+static_assert(Defaults["Limits"][1].As<std::int64_t>() == -12);
+static_assert(Defaults["Limits"][2].As<double>() == 1.5);
+static_assert(Defaults["Limits"][3].As<double>() == 2.5e-3);
+static_assert(Defaults["Limits"][4].As<double>() == 0);
+static_assert(Defaults["Limits"][5].Is<double>());
+static_assert(Defaults["Tags"].As<Core::Constant::Array>().Empty());
+static_assert(Defaults["Owner"].Is<std::nullptr_t>());
+static_assert(!Defaults.Root().As<Core::Constant::Object>().Contains("Missing"));
+
+// Whether the literal fails to parse, the parser throwing not being a constant expression
+
+template <Core::Constant::Text Source>
+constexpr bool Rejected = !requires { typename std::integral_constant<std::size_t, Core::Constant::Parser{Source.View()}.Parse()>; };
+
+static_assert(!Rejected<R"({"a" : [1, 0, -0.5, "b"]})">);
+static_assert(!Rejected<R"(["é"])">);
+static_assert(Rejected<"007">);
+static_assert(Rejected<"-01">);
+static_assert(Rejected<R"({"a" : "x\"y"})">);
+static_assert(Rejected<"\"tab\there\"">);
+static_assert(Rejected<R"({"a" : 1)">);
+static_assert(Rejected<R"("open)">);
+static_assert(Rejected<"[1, ]">);
+static_assert(Rejected<R"({"a" : 1,})">);
+static_assert(Rejected<"[1] 2">);
+static_assert(Rejected<"1.">);
+static_assert(Rejected<"nul">);
+static_assert(Rejected<"1e400">);
+static_assert(Rejected<"[2e308]">);
+static_assert(!Rejected<"[1.7e308, 1e-400, 0e999]">);
+
+int main(int, char const *[])
+{
+    std::string Input = STRINGIFY({
+        "Server" : {"Host" : "localhost", "Port" : 8080, "Secure" : false},
+        "Limits" : [ 0, -12, 1.5, 2.5e-3, -1e-400, 123456789012345678901 ],
+        "Tags" : [],
+        "Owner" : null
+    });
+
+    std::int64_t Port = 0;
+
+    double Startup = Measure([&]
+                             { Port += Json::From(Input)["Server"]["Port"].As<std::int64_t>(); },
+                             100000);
+
+    double Compiled = Measure([&]
+                              { Port += Defaults["Server"]["Port"].As<std::int64_t>(); },
+                              100000);
+
+    std::printf("parsed at startup  %8.1f ns per read\n", Startup * 1e9);
+    std::printf("parsed compiling   %8.1f ns per read  (%lld)\n", Compiled * 1e9, static_cast<long long>(Port));
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include <string>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <Core/Format/Json.hpp>
+#include <Core/Format/Json/File.hpp>
+#include "Benchmark.hpp"
+
+// Loading a large fixture by reading it into a string against mapping it, both parsed into
+// string_view documents
+
+template <typename J>
+using type = Core::DefaultStrategy<J, std::string_view, double, int64_t, bool, std::nullptr_t>;
+
+using Json = Core::Json<std::string_view, type>;
+
+int main(int, char const *[])
+{
+    auto Fixture = std::filesystem::temp_directory_path() / "CppJsonFileBenchmark.json";
+
+    {
+        std::ofstream Output{Fixture, std::ios::binary};
+
+        Output << "{\"Records\":[";
+
+        for (std::size_t i = 0; i < 400000; ++i)
+            Output << (i ? "," : "") << "{\"Id\":" << i << ",\"Name\":\"record " << i << "\",\"Tags\":[\"a\",\"b\"],\"Score\":" << i % 100 << ".5}";
+
+        Output << "]}";
+    }
+
+    std::size_t Size = std::filesystem::file_size(Fixture);
+
+    double Read = Measure([&]
+                          {
+                              std::ifstream Input{Fixture, std::ios::binary};
+                              std::stringstream Buffer;
+                              Buffer << Input.rdbuf();
+
+                              auto Content = Buffer.str();
+                              auto Object = Json::From(Content); },
+                          5);
+
+    double Mapped = Measure([&]
+                            { auto Document = Core::FromFile<Json>(Fixture); },
+                            5);
+
+    std::printf("%zu bytes\n", Size);
+    std::printf("read + copy + parse  %8.1f ms\n", Read * 1e3);
+    std::printf("FromFile (mmap)      %8.1f ms  %.2fx\n", Mapped * 1e3, Read / Mapped);
+
+    std::filesystem::remove(Fixture);
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include <string>
+#include <cstdio>
+#include <Core/Format/Json.hpp>
+#include <Core/Format/Json/NdJson.hpp>
+#define BENCHMARK_COUNT_HEAP
+#include "Benchmark.hpp"
+
+// Memory held and time spent parsing a batch of records sharing one schema, then looking a
+// member up in each of them, with string keys against interned keys
+
+template <typename J>
+using type = Core::DefaultStrategy<J, std::string, double, int64_t, bool, std::nullptr_t>;
+
+template <typename TKey, typename TValue>
+using Hash = Core::HashMap<TKey, TValue>;
+
+using StringJson = Core::Json<std::string, type>;
+using SymbolJson = Core::Json<Core::Symbol, type>;
+using HashedJson = Core::Json<Core::Symbol, type, Hash>;
+
+std::string Records(std::size_t Count)
+{
+    std::string Result;
+
+    for (std::size_t i = 0; i < Count; ++i)
+    {
+        Result += "{\"RequestIdentifier\":" + std::to_string(i) + ",\"CustomerAccountNumber\":" + std::to_string(i % 977) +
+                  ",\"ShippingDestinationCountry\":\"NL\",\"OrderTotalAmount\":" + std::to_string(i % 500) +
+                  ".5,\"PaymentMethodDescription\":\"card\",\"IsExpeditedDelivery\":" + (i % 3 ? "false" : "true") +
+                  ",\"WarehouseLocationCode\":\"AMS-" + std::to_string(i % 12) + "\",\"Notes\":null}\n";
+    }
+
+    return Result;
+}
+
+template <typename TJson>
+void Run(char const *Name, std::string_view Input)
+{
+    std::vector<TJson> Documents;
+
+    Documents.reserve(200000);
+
+    std::size_t Before = HeapBytes;
+
+    double Parse = Measure([&]
+                           { Core::NdJson::Records(Input, [&](std::string_view Record)
+                                                   { Documents.push_back(TJson::From(Record)); }); });
+
+    std::size_t Held = HeapBytes - Before;
+
+    typename TJson::Key Key{"WarehouseLocationCode"};
+    std::size_t Found = 0;
+
+    double Lookup = Measure([&]
+                            {
+                                for (auto &Document : Documents)
+                                    Found += Document.GetMap().find(Key) != Document.GetMap().end(); });
+
+    std::printf("%-16s parse %8.1f MB/s  lookup %6.1f ns  %8.1f MB allocated  (%zu found)\n",
+                Name, Input.size() / Parse / 1e6, Lookup / Documents.size() * 1e9, Held / 1e6, Found);
+}
+
+int main(int, char const *[])
+{
+    auto Input = Records(200000);
+
+    std::printf("%zu bytes\n", Input.size());
+
+    Run<StringJson>("std::string", Input);
+    Run<SymbolJson>("shared symbols", Input);
+
+    {
+        Core::Symbol::Pool Keys;
+        Core::Symbol::Session Session{Keys};
+
+        Run<SymbolJson>("session symbols", Input);
+        Run<HashedJson>("hashed symbols", Input);
+    }
+
+    return 0;
+}
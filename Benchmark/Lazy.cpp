@@ -0,0 +1,50 @@
+#include <string>
+#include <cstdio>
+#include <Core/Format/Json.hpp>
+#include "Benchmark.hpp"
+
+// Reading a single field out of a large envelope, fully parsed against parsed on demand
+
+template <typename J>
+using type = Core::DefaultStrategy<J, std::string, double, int64_t, bool, std::nullptr_t>;
+
+template <typename J>
+using lazy = Core::LazyStrategy<J, std::string, double, int64_t, bool, std::nullptr_t>;
+
+using Json = Core::Json<std::string, type>;
+using LazyJson = Core::Json<std::string, lazy>;
+
+std::string Envelope()
+{
+    std::string Result = "{\"Meta\":{\"Id\":42,\"Source\":\"billing\"},\"Payload\":[";
+
+    for (std::size_t i = 0; Result.size() < 1024 * 1024; ++i)
+    {
+        Result += i ? "," : "";
+        Result += "{\"Line\":" + std::to_string(i) + ",\"Sku\":\"sku-" + std::to_string(i) +
+                  "\",\"Amount\":" + std::to_string(i % 300) + ".75,\"Taxed\":true,\"Notes\":[\"x\",\"y\"]}";
+    }
+
+    return Result + "]}";
+}
+
+int main(int, char const *[])
+{
+    auto Input = Envelope();
+
+    std::int64_t Id = 0, LazyId = 0;
+
+    double Full = Measure([&]
+                          { Id = Json::From(Input)["Meta"]["Id"].As<std::int64_t>(); },
+                          20);
+
+    double OnDemand = Measure([&]
+                              { LazyId = LazyJson::From(Input)["Meta"]["Id"].As<std::int64_t>(); },
+                              20);
+
+    std::printf("%zu bytes\n", Input.size());
+    std::printf("full parse   %8.3f ms  (Id %lld)\n", Full * 1e3, static_cast<long long>(Id));
+    std::printf("on demand    %8.3f ms  (Id %lld)  %.1fx\n", OnDemand * 1e3, static_cast<long long>(LazyId), Full / OnDemand);
+
+    return 0;
+}
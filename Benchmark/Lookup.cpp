@@ -0,0 +1,138 @@
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <stdexcept>
+#include <Core/Format/Json.hpp>
+#include "Benchmark.hpp"
+
+// Lookups where most keys are missing, through the throwing paths (std::map::at and
+// operator[] on a value that isn't an object, both caught) against Find and TryGet which
+// report a miss without throwing. operator[] on a Json inserts on a miss, the number of
+// members it adds is printed as well. Also compares From and TryFrom on valid input.
+
+template <typename J>
+using type = Core::DefaultStrategy<J, std::string, double, int64_t, bool, std::nullptr_t>;
+
+using Json = Core::Json<std::string, type>;
+
+std::string Records(std::size_t Count)
+{
+    std::string Result = "{\"Records\":[";
+
+    for (std::size_t i = 0; i < Count; ++i)
+    {
+        Result += i ? "," : "";
+        Result += "{\"Id\":" + std::to_string(i) + ",\"Name\":\"record\",\"Score\":" + std::to_string(i % 100) +
+                  ",\"Tags\":[\"a\",\"b\"],\"Owner\":" + (i % 2 ? "null" : "{\"Id\":1}") + "}";
+    }
+
+    return Result + "]}";
+}
+
+int main(int, char const *[])
+{
+    auto Input = Records(20000);
+    auto Object = Json::From(Input);
+    auto &Records = Object["Records"].As<Json::Array>();
+
+    // One key in ten is present
+
+    std::vector<std::string> Keys = {"Id", "Missing", "Other", "Unknown", "Absent", "Gone", "Nope", "Null", "Void", "None"};
+
+    std::size_t Lookups = Records.size() * Keys.size();
+    std::int64_t Found = 0;
+
+    double At = Measure<std::nano>([&]
+                                   {
+                                       for (auto &Record : Records)
+                                           for (auto const &Key : Keys)
+                                           {
+                                               try
+                                               {
+                                                   Found += Record.As<Json>().GetMap().at(Key).As<std::int64_t>();
+                                               }
+                                               catch (std::out_of_range const &)
+                                               {
+                                               }
+                                           } },
+                                   3) /
+                Lookups;
+
+    // The owner is null every other record, which operator[] throws on
+
+    double Nested = Measure<std::nano>([&]
+                                       {
+                                           for (auto &Record : Records)
+                                               for (std::size_t k = 0; k < Keys.size(); ++k)
+                                               {
+                                                   try
+                                                   {
+                                                       Found += Record["Owner"]["Id"].As<std::int64_t>();
+                                                   }
+                                                   catch (std::invalid_argument const &)
+                                                   {
+                                                   }
+                                               } },
+                                       3) /
+                    Lookups;
+
+    double Find = Measure<std::nano>([&]
+                                     {
+                                         for (auto &Record : Records)
+                                             for (auto const &Key : Keys)
+                                                 if (auto Member = Record.Find(Key))
+                                                     Found += Member->As<std::int64_t>(); },
+                                     3) /
+                  Lookups;
+
+    double NestedFind = Measure<std::nano>([&]
+                                           {
+                                               for (auto &Record : Records)
+                                                   for (std::size_t k = 0; k < Keys.size(); ++k)
+                                                       if (auto Owner = Record.Find("Owner"))
+                                                           Found += Owner->TryGet<std::int64_t>("Id").value_or(0); },
+                                           3) /
+                        Lookups;
+
+    double TryGet = Measure<std::nano>([&]
+                                       {
+                                           for (auto &Record : Records)
+                                               for (auto const &Key : Keys)
+                                                   Found += Record.TryGet<std::int64_t>(Key).value_or(0); },
+                                       3) /
+                    Lookups;
+
+    auto Copy = Json::From(Input);
+    std::size_t Before = 0, After = 0;
+
+    for (auto &Record : Copy["Records"].As<Json::Array>())
+    {
+        Before += Record.As<Json>().GetMap().size();
+
+        for (auto const &Key : Keys)
+            Record.As<Json>()[Key];
+
+        After += Record.As<Json>().GetMap().size();
+    }
+
+    std::printf("%zu lookups, 90%% misses\n", Lookups);
+    std::printf("at + catch            %8.2f ns/lookup\n", At);
+    std::printf("operator[] + catch    %8.2f ns/lookup\n", Nested);
+    std::printf("Find                  %8.2f ns/lookup  %.1fx over at\n", Find, At / Find);
+    std::printf("Find + TryGet         %8.2f ns/lookup  %.1fx over operator[]\n", NestedFind, Nested / NestedFind);
+    std::printf("TryGet                %8.2f ns/lookup  %.1fx over at\n", TryGet, At / TryGet);
+    std::printf("Json::operator[] added %zu members to %zu  (%lld)\n", After - Before, Before, static_cast<long long>(Found));
+
+    double Parse = Measure<std::nano>([&]
+                                      { Json::From(Input); },
+                                      5);
+
+    double TryParse = Measure<std::nano>([&]
+                                         { Json::TryFrom(Input); },
+                                         5);
+
+    std::printf("From                  %8.1f MB/s\n", Input.size() / Parse * 1e3);
+    std::printf("TryFrom               %8.1f MB/s\n", Input.size() / TryParse * 1e3);
+
+    return 0;
+}
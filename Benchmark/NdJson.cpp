@@ -0,0 +1,55 @@
+#include <string>
+#include <cstdio>
+#include <Core/Format/Json.hpp>
+#include <Core/Format/Json/NdJson.hpp>
+#include "Benchmark.hpp"
+
+// Parse throughput of a newline delimited log batch against the number of worker threads
+
+template <typename J>
+using type = Core::DefaultStrategy<J, std::string_view, double, int64_t, bool, std::nullptr_t>;
+
+using Json = Core::Json<std::string_view, type>;
+
+std::string Logs(std::size_t Records)
+{
+    std::string Result;
+
+    for (std::size_t i = 0; i < Records; ++i)
+    {
+        Result += "{\"Time\":" + std::to_string(1700000000 + i) + ",\"Level\":\"" + (i % 7 ? "info" : "warn") +
+                  "\",\"Service\":\"gateway\",\"Latency\":" + std::to_string(i % 1000) + ".25,\"Path\":\"/api/v1/items/" +
+                  std::to_string(i) + "\",\"Tags\":[\"a\",\"b\",\"c\"],\"Cached\":" + (i % 2 ? "true" : "false") + "}\n";
+    }
+
+    return Result;
+}
+
+int main(int, char const *[])
+{
+    auto Input = Logs(200000);
+
+    std::vector<Json> Documents;
+
+    // Both sides keep the documents so destruction stays out of the measurement
+
+    double Sequential = Measure([&]
+                                { Core::NdJson::Records(Input, [&](std::string_view Record)
+                                                        { Documents.push_back(Json::From(Record)); }); });
+
+    std::printf("%zu bytes, %zu hardware threads\n", Input.size(), Core::Parallel::Workers());
+    std::printf("sequential    %8.1f MB/s  (%zu records)\n", Input.size() / Sequential / 1e6, Documents.size());
+
+    for (std::size_t Threads : {1, 2, 4, 8, 16})
+    {
+        Documents.clear();
+
+        double Seconds = Measure([&]
+                                 { Documents = Core::NdJson::Parse<Json>(Input, Threads); });
+
+        std::printf("threads %3zu   %8.1f MB/s  speedup %5.2fx  (%zu records)\n",
+                    Threads, Input.size() / Seconds / 1e6, Sequential / Seconds, Documents.size());
+    }
+
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include <string>
+#include <cstdio>
+#include <Core/Format/Json.hpp>
+#include "Benchmark.hpp"
+
+// Parsing documents of the same size nested ever deeper. Every byte being visited once, the
+// throughput stays flat whatever the depth, where a parser rescanning each nested value would
+// slow down in proportion to it.
+
+template <typename J>
+using type = Core::DefaultStrategy<J, std::string, double, int64_t, bool, std::nullptr_t>;
+
+using Json = Core::Json<std::string, type>;
+
+// Chains of Depth containers, objects and arrays alternating, around a small record
+
+std::string Nested(std::size_t Depth)
+{
+    std::string Result = "{\"Chains\":[";
+
+    for (std::size_t i = 0; Result.size() < 1024 * 1024; ++i)
+    {
+        Result += i ? "," : "";
+
+        for (std::size_t Level = 0; Level < Depth; ++Level)
+            Result += Level % 2 ? "[" : "{\"Next\":";
+
+        Result += "{\"Id\":" + std::to_string(i) + ",\"Name\":\"node\",\"Ready\":true}";
+
+        for (std::size_t Level = Depth; Level--;)
+            Result += Level % 2 ? "]" : "}";
+    }
+
+    return Result + "]}";
+}
+
+int main(int, char const *[])
+{
+    for (std::size_t Depth : {1, 2, 4, 8, 16, 32, 64, 128, 256, 512})
+    {
+        auto Input = Nested(Depth);
+
+        double Parse = Measure([&]
+                               { Json::From(Input); },
+                               10);
+
+        std::printf("depth %4zu  %8zu bytes  %8.1f MB/s\n", Depth, Input.size(), Input.size() / Parse / 1e6);
+    }
+
+    return 0;
+}
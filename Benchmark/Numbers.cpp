@@ -0,0 +1,66 @@
+#include <string>
+#include <cstdio>
+#include <Core/Format/Json.hpp>
+#include <Core/Format/Json/Writer.hpp>
+#include "Benchmark.hpp"
+
+// Number heavy documents parsed into doubles and integers against keeping the numbers as
+// text, then passed through to the serializer
+
+template <typename J>
+using type = Core::DefaultStrategy<J, std::string, double, int64_t, bool, std::nullptr_t>;
+
+using Json = Core::Json<std::string, type>;
+
+template <typename J>
+using raw = Core::DefaultStrategy<J, std::string, Core::Number, bool, std::nullptr_t>;
+
+using Raw = Core::Json<std::string, raw>;
+
+std::string Payload()
+{
+    std::string Result = "{\"Samples\":[";
+
+    for (std::size_t i = 0; Result.size() < 1024 * 1024; ++i)
+    {
+        Result += i ? "," : "";
+        Result += "{\"Id\":" + std::to_string(i * 7919) + ",\"Position\":[" + std::to_string(i * 0.731) + "," +
+                  std::to_string(-(i * 1.337)) + "," + std::to_string(i % 97 * 3.14159e-3) + "],\"Weight\":" +
+                  std::to_string(i % 1000) + ".5e-2}";
+    }
+
+    return Result + "]}";
+}
+
+int main(int, char const *[])
+{
+    auto Input = Payload();
+    double Megabytes = Input.size() / (1024.0 * 1024.0);
+
+    auto Converted = Json::From(Input);
+    auto Kept = Raw::From(Input);
+
+    std::string Output;
+
+    double Parse = Measure([&]
+                           { Converted = Json::From(Input); },
+                           20);
+
+    double ParseRaw = Measure([&]
+                              { Kept = Raw::From(Input); },
+                              20);
+
+    double Pass = Measure([&]
+                          { Output = Core::Serialize(Json::From(Input)); },
+                          20);
+
+    double PassRaw = Measure([&]
+                             { Output = Core::Serialize(Raw::From(Input)); },
+                             20);
+
+    std::printf("%zu bytes\n", Input.size());
+    std::printf("parse          converted %7.1f MB/s  raw %7.1f MB/s  %.2fx\n", Megabytes / Parse, Megabytes / ParseRaw, Parse / ParseRaw);
+    std::printf("parse + write  converted %7.1f MB/s  raw %7.1f MB/s  %.2fx\n", Megabytes / Pass, Megabytes / PassRaw, Pass / PassRaw);
+
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include <string>
+#include <cstdio>
+#include <Core/Format/Json.hpp>
+#include <Core/Format/Json/Path.hpp>
+#include "Benchmark.hpp"
+
+// Extracting a few values out of a large payload through the tree against Json pointer queries
+
+template <typename J>
+using type = Core::DefaultStrategy<J, std::string, double, int64_t, bool, std::nullptr_t>;
+
+using Json = Core::Json<std::string, type>;
+
+std::string Payload()
+{
+    std::string Result = "{\"Map\":{\"Records\":[";
+
+    for (std::size_t i = 0; Result.size() < 1024 * 1024; ++i)
+    {
+        Result += i ? "," : "";
+        Result += "{\"Id\":" + std::to_string(i) + ",\"Text\":\"record " + std::to_string(i) +
+                  "\",\"Values\":[1,2,3,4],\"Nested\":{\"Deep\":{\"Deeper\":true}}}";
+    }
+
+    return Result + "],\"JsonList\":[{\"s\":\"wanted\"}],\"Version\":3}}";
+}
+
+int main(int, char const *[])
+{
+    auto Input = Payload();
+
+    Core::Path Wanted{"/Map/JsonList/0/s"};
+    Core::Path Version{"/Map/Version"};
+    Core::Path Ids{"/Map/Records/*/Id"};
+
+    std::string Found;
+    std::size_t Count = 0;
+
+    double Tree = Measure([&]
+                          {
+                              auto Object = Json::From(Input);
+                              Found = Object["Map"]["JsonList"][0]["s"].As<std::string>(); },
+                          20);
+
+    double Query = Measure([&]
+                           { Found = *Wanted.First(Input); },
+                           20);
+
+    double Shared = Measure([&]
+                            {
+                                Core::Structural::Index Positions{Input};
+
+                                Wanted.Each(Positions, [&](std::string_view Raw)
+                                            { Found = Raw; });
+                                Version.Each(Positions, [&](std::string_view Raw)
+                                             { Found = Raw; });
+                                Count = 0;
+                                Ids.Each(Positions, [&](std::string_view)
+                                         { ++Count; }); },
+                            20);
+
+    std::printf("%zu bytes\n", Input.size());
+    std::printf("Json::From + operator[]   %8.3f ms\n", Tree * 1e3);
+    std::printf("Path::First               %8.3f ms  %.1fx\n", Query * 1e3, Tree / Query);
+    std::printf("3 paths on one index      %8.3f ms  (%zu ids)\n", Shared * 1e3, Count);
+
+    return 0;
+}
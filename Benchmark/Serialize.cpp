@@ -0,0 +1,79 @@
+#include <string>
+#include <cstdio>
+#include <sstream>
+#include <Core/Format/Json.hpp>
+#include <Core/Format/Json/Writer.hpp>
+#include "Benchmark.hpp"
+
+// Serialization throughput of the ostream operators against the buffer writer
+
+template <typename J>
+using type = Core::DefaultStrategy<J, std::string, double, int64_t, bool, std::nullptr_t>;
+
+using Json = Core::Json<std::string, type>;
+
+std::string Response()
+{
+    std::string Result = "{\"Status\":\"ok\",\"Results\":[";
+
+    for (std::size_t i = 0; Result.size() < 1024 * 1024; ++i)
+    {
+        Result += i ? "," : "";
+        Result += "{\"Id\":" + std::to_string(i * 7919) + ",\"Name\":\"result " + std::to_string(i) +
+                  "\",\"Score\":" + std::to_string(i % 1000) + ".125,\"Ratio\":0.3333333333333333,\"Tags\":[\"alpha\",\"beta\"],\"Visible\":true,\"Owner\":null}";
+    }
+
+    return Result + "]}";
+}
+
+int main(int, char const *[])
+{
+    auto Object = Json::From(Response());
+
+    std::size_t Size = 0;
+
+    double Stream = Measure([&]
+                            {
+                                std::stringstream Output;
+                                Output << Object;
+                                Size = Output.str().size(); },
+                            20);
+
+    std::printf("stringstream        %8.1f MB/s  (%zu bytes)\n", Size / Stream / 1e6, Size);
+
+    double Buffer = Measure([&]
+                            { Size = Core::Serialize(Object).size(); },
+                            20);
+
+    std::printf("Serialize           %8.1f MB/s  (%zu bytes, estimated %zu)  %.1fx\n",
+                Size / Buffer / 1e6, Size, Core::Estimate(Object), Stream / Buffer);
+
+    std::string Reused;
+
+    double Appended = Measure([&]
+                              {
+                                  Reused.clear();
+                                  Core::Serialize(Object, Reused); },
+                              20);
+
+    std::printf("Serialize, reused   %8.1f MB/s  %.1fx\n", Reused.size() / Appended / 1e6, Stream / Appended);
+
+    std::size_t Written = 0;
+
+    double Sink = Measure([&]
+                          {
+                              Written = 0;
+                              Core::Serialize(Object, [&](std::string_view Piece)
+                                              { Written += Piece.size(); }); },
+                          20);
+
+    std::printf("Serialize, sink     %8.1f MB/s  %.1fx\n", Written / Sink / 1e6, Stream / Sink);
+
+    double Pretty = Measure([&]
+                            { Size = Core::Serialize(Object, {.Pretty = true}).size(); },
+                            20);
+
+    std::printf("Serialize, pretty   %8.1f MB/s  (%zu bytes)\n", Size / Pretty / 1e6, Size);
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <Core/Format/Json.hpp>
+#include <Core/Format/Json/Shared.hpp>
+#include <Core/Format/Json/Writer.hpp>
+#include "Benchmark.hpp"
+
+// Taking a snapshot of a large document and editing one nested value of it, with the tree
+// copied by DefaultStrategy against shared by SharedStrategy. Bytes allocated per snapshot
+// and edit are counted through a CountingResource, the storages being the std::pmr ones.
+// It is the default resource during the run since copies of them allocate from it.
+// The snapshots have to keep the document as it was.
+
+template <typename J>
+using type = Core::DefaultStrategy<J, std::pmr::string, double, int64_t, bool, std::nullptr_t>;
+
+template <typename J>
+using sharedtype = Core::SharedStrategy<J, std::pmr::string, double, int64_t, bool, std::nullptr_t>;
+
+using Json = Core::Json<std::pmr::string, type, std::pmr::map, std::pmr::vector>;
+using SharedJson = Core::Json<std::pmr::string, sharedtype, std::pmr::map, std::pmr::vector>;
+
+std::string Services(std::size_t Count)
+{
+    std::string Result = "{\"Services\":[";
+
+    for (std::size_t i = 0; i < Count; ++i)
+    {
+        Result += i ? "," : "";
+        Result += "{\"Name\":\"service" + std::to_string(i) + "\",\"Replicas\":" + std::to_string(i % 5 + 1) +
+                  ",\"Limits\":{\"Cpu\":0.5,\"Memory\":\"512Mi\"},\"Ports\":[80,443],\"Env\":{\"Mode\":\"production\",\"Debug\":false}}";
+    }
+
+    return Result + "]}";
+}
+
+template <typename J>
+bool Run(char const *Name, std::string const &Input, std::size_t Iterations)
+{
+    Core::CountingResource Counter;
+
+    auto Previous = std::pmr::set_default_resource(&Counter);
+
+    Core::Structural::Index Positions{Input};
+    Core::Structural::Cursor Cursor{Positions};
+
+    auto Document = J::Value::From(Cursor, &Counter);
+    auto Original = Core::Serialize(Document);
+
+    std::vector<typename J::Value> Snapshots;
+
+    Snapshots.reserve(Iterations);
+
+    std::size_t Before = Counter.BytesAllocated();
+
+    double Time = Measure<std::nano>([&]
+                                     {
+                                         Snapshots.push_back(Document);
+                                         Document["Services"][Snapshots.size() % 1000]["Replicas"] = static_cast<int64_t>(Snapshots.size()); },
+                                     Iterations);
+
+    std::printf("%-8s snapshot + edit %10.0f ns  %10.0f bytes\n", Name, Time, static_cast<double>(Counter.BytesAllocated() - Before) / Iterations);
+
+    bool Kept = Core::Serialize(Snapshots.front()) == Original && Core::Serialize(Snapshots.back()) != Original;
+
+    Snapshots.clear();
+    std::pmr::set_default_resource(Previous);
+
+    return Kept;
+}
+
+int main(int, char const *[])
+{
+    auto Input = Services(10000);
+
+    std::printf("%zu bytes\n", Input.size());
+
+    bool Kept = Run<Json>("Default", Input, 20);
+    Kept &= Run<SharedJson>("Shared", Input, 20);
+
+    if (!Kept)
+    {
+        std::printf("mismatch\n");
+        return 1;
+    }
+
+    return 0;
+}
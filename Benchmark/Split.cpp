@@ -0,0 +1,100 @@
+#include <string>
+#include <cstdio>
+#include <Core/Format/Json.hpp>
+#include <Core/Format/Json/Split.hpp>
+#include <Core/Format/Json/Writer.hpp>
+#include "Benchmark.hpp"
+
+// Parse throughput of one document holding a large array against the number of worker
+// threads, for the array at the root and for the array under a key. Every parallel parse is
+// checked to give the tree of the sequential one, malformed input included.
+
+template <typename J>
+using type = Core::DefaultStrategy<J, std::string_view, double, int64_t, bool, std::nullptr_t>;
+
+using Json = Core::Json<std::string_view, type>;
+using Value = Json::Value;
+
+std::string Records(std::size_t Count)
+{
+    std::string Result = "[";
+
+    for (std::size_t i = 0; i < Count; ++i)
+    {
+        Result += i ? "," : "";
+        Result += "{\"Id\":" + std::to_string(i) + ",\"Name\":\"record " + std::to_string(i) + "\",\"Score\":" +
+                  std::to_string(i % 1000) + ".5,\"Tags\":[\"a\",\"b\",\"c\"],\"Active\":" + (i % 2 ? "true" : "false") + "}";
+    }
+
+    return Result + "]";
+}
+
+// Malformed elements keep the tree to what the sequential parse gives, the elements after the
+// first error being dropped, whichever thread reaches them first
+
+bool Malformed()
+{
+    for (std::string_view Input : {R"({"Records":[1,2,tru,4,5,6,7,8],"Next":null})", R"({"Records":[1,{"a":[1,}],3,4,5,6],"Next":null})",
+                                   R"({"Records":[1,2,3,4,5,6,7,"x\q"],"Next":null})"})
+    {
+        auto Sequential = Core::Serialize(Json::From(Input));
+
+        if (Core::Serialize(Core::Split::From<Json>(Input, {"Records"}, 4)) != Sequential)
+        {
+            std::printf("malformed mismatch for %.*s\n", static_cast<int>(Input.size()), Input.data());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int, char const *[])
+{
+    if (!Malformed())
+        return 1;
+
+    auto Root = Records(200000);
+    auto Nested = "{\"Total\":200000,\"Records\":" + Root + ",\"Next\":null}";
+
+    Value Expected, Result;
+    Json ExpectedObject, ResultObject;
+
+    // Both sides keep the trees so destruction stays out of the measurement
+
+    double Sequential = Measure([&]
+                                {
+                                    Core::Structural::Index Positions{Root};
+                                    Core::Structural::Cursor Cursor{Positions};
+
+                                    Expected = Value::From(Cursor); });
+
+    double SequentialObject = Measure([&]
+                                      { ExpectedObject = Json::From(Nested); });
+
+    std::printf("%zu bytes, %zu hardware threads\n", Root.size(), Core::Parallel::Workers());
+    std::printf("sequential    %8.1f MB/s  root   %8.1f MB/s  member\n", Root.size() / Sequential / 1e6, Nested.size() / SequentialObject / 1e6);
+
+    for (std::size_t Threads : {1, 2, 4, 8, 16})
+    {
+        Result = Value{};
+        ResultObject = Json{};
+
+        double Seconds = Measure([&]
+                                 { Result = Core::Split::From<Value>(Root, {}, Threads); });
+
+        double SecondsObject = Measure([&]
+                                       { ResultObject = Core::Split::From<Json>(Nested, {"Records"}, Threads); });
+
+        if (!(Result == Expected) || Core::Serialize(ResultObject) != Core::Serialize(ExpectedObject))
+        {
+            std::printf("mismatch with %zu threads\n", Threads);
+            return 1;
+        }
+
+        std::printf("threads %3zu   %8.1f MB/s  speedup %5.2fx  member speedup %5.2fx\n",
+                    Threads, Root.size() / Seconds / 1e6, Sequential / Seconds, SequentialObject / SecondsObject);
+    }
+
+    return 0;
+}
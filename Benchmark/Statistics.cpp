@@ -0,0 +1,78 @@
+#include <string>
+#include <cstdio>
+#include <Core/Format/Json.hpp>
+#include "Benchmark.hpp"
+
+// Cost of filling statistics in while parsing, against the plain parse
+
+template <typename J>
+using type = Core::DefaultStrategy<J, std::string, double, int64_t, bool, std::nullptr_t>;
+
+using Json = Core::Json<std::string, type>;
+
+std::string Response()
+{
+    std::string Result = "{\"Status\":\"ok\",\"Results\":[";
+
+    for (std::size_t i = 0; Result.size() < 1024 * 1024; ++i)
+    {
+        Result += i ? "," : "";
+        Result += "{\"Id\":" + std::to_string(i * 7919) + ",\"Name\":\"result\\t" + std::to_string(i) +
+                  "\",\"Score\":" + std::to_string(i % 1000) + ".125,\"Tags\":[\"alpha\",\"beta\"],\"Visible\":true,\"Owner\":null}";
+    }
+
+    return Result + "]}";
+}
+
+// Parsing from a cursor records the same as parsing the text, the indexing time aside
+
+bool Consistent(std::string const &Input)
+{
+    Core::Statistics Text, Cursor;
+
+    Json::From(Input, Text);
+
+    Core::Structural::Index Positions{Input};
+    Core::Structural::Cursor Walk{Positions};
+
+    Json::Value::From(Walk, Cursor);
+
+    if (Text.Documents != 1 || Cursor.Documents != 1 || Text.Bytes != Input.size() || Cursor.Bytes != Input.size() ||
+        Text.Objects != Cursor.Objects || Text.Copies != Cursor.Copies || Cursor.Building.count() == 0)
+    {
+        std::printf("statistics differ, %zu and %zu documents of %zu and %zu bytes\n", Text.Documents, Cursor.Documents, Text.Bytes, Cursor.Bytes);
+        return false;
+    }
+
+    return true;
+}
+
+int main(int, char const *[])
+{
+    auto Input = Response();
+
+    if (Core::Statistics::Enabled && !Consistent(Input))
+        return 1;
+
+    double Plain = Measure([&]
+                           { Json::From(Input); },
+                           20);
+
+    Core::Statistics Stats;
+
+    double Counted = Measure([&]
+                             { Json::From(Input, Stats); },
+                             20);
+
+    std::printf("plain         %8.1f MB/s\n", Input.size() / Plain / 1e6);
+    std::printf("statistics    %8.1f MB/s  %+.1f%%%s\n", Input.size() / Counted / 1e6, (Counted / Plain - 1) * 100,
+                Core::Statistics::Enabled ? "" : "  (disabled)");
+
+    std::printf("%zu documents, %zu bytes, %zu objects, %zu arrays, %zu keys, %zu strings, %zu numbers, %zu booleans, %zu nulls\n",
+                Stats.Documents, Stats.Bytes, Stats.Objects, Stats.Arrays, Stats.Keys, Stats.Strings, Stats.Numbers, Stats.Booleans, Stats.Nulls);
+    std::printf("depth %zu, %zu copies of %zu bytes, indexing %.2f ms, building %.2f ms per document\n",
+                Stats.Depth, Stats.Copies, Stats.CopiedBytes,
+                Stats.Indexing.count() / 1e6 / std::max<std::size_t>(Stats.Documents, 1), Stats.Building.count() / 1e6 / std::max<std::size_t>(Stats.Documents, 1));
+
+    return 0;
+}
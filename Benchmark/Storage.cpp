@@ -0,0 +1,91 @@
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <Core/Format/Json.hpp>
+#include "Benchmark.hpp"
+
+// Compares the object storages on parse, member lookup and iteration over
+// documents made of many small (5 to 20 keys) objects and a few wide ones
+
+template <typename J>
+using type = Core::DefaultStrategy<J, std::string_view, double, int64_t, bool, std::nullptr_t>;
+
+template <template <typename, typename> typename TMap>
+using Json = Core::Json<std::string_view, type, TMap>;
+
+template <typename TKey, typename TValue>
+using StdMap = std::map<TKey, TValue>;
+
+template <typename TKey, typename TValue>
+using DefaultHashMap = Core::HashMap<TKey, TValue>;
+
+std::string Document(std::size_t Records, std::size_t Width)
+{
+    std::string Result = "{\"Records\":[";
+
+    for (std::size_t i = 0; i < Records; ++i)
+    {
+        Result += i ? ",{" : "{";
+
+        for (std::size_t k = 0; k < Width; ++k)
+            Result += (k ? ",\"Field" : "\"Field") + std::to_string(k) + "\":" + std::to_string(i * k);
+
+        Result += "}";
+    }
+
+    return Result + "]}";
+}
+
+template <template <typename, typename> typename TMap>
+void Run(char const *Name, std::string const &Input, std::size_t Width)
+{
+    using J = Json<TMap>;
+
+    std::vector<std::string> Keys;
+
+    for (std::size_t k = 0; k < Width; ++k)
+        Keys.push_back("Field" + std::to_string(k));
+
+    double Parse = Measure<std::nano>([&]
+                                      { J::From(Input); },
+                                      5);
+
+    auto Object = J::From(Input);
+    auto &Records = Object["Records"].template As<typename J::Array>();
+
+    std::int64_t Sum = 0;
+
+    double Lookup = Measure<std::nano>([&]
+                                       {
+                                           for (auto &Record : Records)
+                                               for (auto const &Key : Keys)
+                                                   Sum += Record[Key].template As<std::int64_t>(); },
+                                       5) /
+                    (Records.size() * Keys.size());
+
+    double Iterate = Measure<std::nano>([&]
+                                        {
+                                            for (auto &Record : Records)
+                                                for (auto const &[Key, Value] : Record.template As<J>().GetMap())
+                                                    Sum += Value.template As<std::int64_t>(); },
+                                        5) /
+                     (Records.size() * Keys.size());
+
+    std::printf("%-10s width %3zu  parse %8.1f MB/s  lookup %6.2f ns/op  iterate %6.2f ns/op  (%lld)\n",
+                Name, Width, Input.size() / Parse * 1e3, Lookup, Iterate, static_cast<long long>(Sum));
+}
+
+int main(int, char const *[])
+{
+    for (std::size_t Width : {5, 10, 20, 64})
+    {
+        auto Input = Document(200000 / Width, Width);
+
+        Run<StdMap>("std::map", Input, Width);
+        Run<Core::FlatMap>("FlatMap", Input, Width);
+        Run<Core::SortedMap>("SortedMap", Input, Width);
+        Run<DefaultHashMap>("HashMap", Input, Width);
+    }
+
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include <string>
+#include <cstdio>
+#include <stdexcept>
+#include <Core/Format/Json.hpp>
+#include <Core/Format/Json/Writer.hpp>
+#include "Benchmark.hpp"
+
+// Parsing and serializing documents made mostly of strings, once plain and once with escapes
+// and non ASCII text, the latter going through the per string checks and the decoder
+
+template <typename J>
+using type = Core::DefaultStrategy<J, std::string, double, int64_t, bool, std::nullptr_t>;
+
+using Json = Core::Json<std::string, type>;
+
+template <typename J>
+using view = Core::DefaultStrategy<J, std::string_view, double, int64_t, bool, std::nullptr_t>;
+
+template <typename J>
+using lazy = Core::LazyStrategy<J, std::string_view, double, int64_t, bool, std::nullptr_t>;
+
+using Views = Core::Json<std::string_view, view>;
+using LazyViews = Core::Json<std::string_view, lazy>;
+
+// Whether parsing throws the error views of escaped strings on the heap raise
+
+template <typename F>
+bool Throws(F &&Function)
+{
+    try
+    {
+        Function();
+    }
+    catch (std::invalid_argument const &)
+    {
+        return true;
+    }
+
+    return false;
+}
+
+// Views of strings with escapes need an arena to be decoded into. On the heap the parse fails
+// instead of leaving the strings out, whichever of the keys or values holds the escapes.
+
+bool Escapes()
+{
+    for (std::string_view Input : {R"({"a":"x\"y","b":1})", R"({"a\n":1})", R"(["x\u00e9"])"})
+    {
+        if (!Throws([&]
+                    { Views::From(Input); }) ||
+            !Throws([&]
+                    { LazyViews::From(Input); }))
+        {
+            std::printf("kept %.*s\n", static_cast<int>(Input.size()), Input.data());
+            return false;
+        }
+
+        if (auto Result = Views::TryFrom(Input); Result || Result.GetStatus().Code != Core::Error::String)
+        {
+            std::printf("no string error for %.*s\n", static_cast<int>(Input.size()), Input.data());
+            return false;
+        }
+    }
+
+    // Malformed escapes fail the parse as they do for any string type
+
+    if (Throws([]
+               { Views::From(R"(["x\q"])"); }))
+    {
+        std::printf("malformed escape refused\n");
+        return false;
+    }
+
+    Core::Arena Arena;
+
+    auto Decoded = Views::From(R"({"a":"x\"y","b":1})", &Arena);
+
+    return Decoded["a"].As<std::string_view>() == "x\"y" && Core::Serialize(Decoded) == R"({"a":"x\"y","b":1})";
+}
+
+std::string Payload(bool Escaped)
+{
+    std::string Result = "{\"Users\":[";
+
+    for (std::size_t i = 0; Result.size() < 1024 * 1024; ++i)
+    {
+        Result += i ? "," : "";
+        Result += "{\"Name\":\"user " + std::to_string(i) + "\",\"Bio\":\"";
+        Result += Escaped ? "said \\\"h\\u00e9llo\\\"\\n\\tto \\ud83d\\ude00 and w\xc3\xb6rld, then left"
+                          : "said hello to everyone in the room and then left the building";
+        Result += "\"}";
+    }
+
+    return Result + "]}";
+}
+
+int main(int, char const *[])
+{
+    if (!Escapes())
+        return 1;
+
+    for (bool Escaped : {false, true})
+    {
+        auto Input = Payload(Escaped);
+        auto Tree = Json::From(Input);
+
+        std::string Output;
+
+        double Parse = Measure([&]
+                               { Tree = Json::From(Input); },
+                               20);
+
+        double Write = Measure([&]
+                               { Output = Core::Serialize(Tree); },
+                               20);
+
+        double Megabytes = Input.size() / (1024.0 * 1024.0);
+
+        std::printf("%-8s parse %7.1f MB/s  serialize %7.1f MB/s  (%zu bytes in, %zu out)\n",
+                    Escaped ? "escaped" : "plain", Megabytes / Parse, Megabytes / Write, Input.size(), Output.size());
+    }
+
+    return 0;
+}
@@ -0,0 +1,444 @@
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <variant>
+#include <Core/Format/Json.hpp>
+#include <Core/Format/Json/Writer.hpp>
+#include <Core/Format/Json/NdJson.hpp>
+#define BENCHMARK_COUNT_HEAP
+#include "Benchmark.hpp"
+
+// Regression suite over generated corpora, needing nothing but the library. Every corpus is
+// parsed, serialized, queried at random paths and destroyed, and each measurement is written
+// to stdout as one Json object per line so runs can be stored and compared, a readable table
+// going to stderr. An argument only runs the corpora whose name contains it.
+//
+//     SuiteBenchmark > results.ndjson
+//     SuiteBenchmark numbers
+
+template <typename J>
+using type = Core::DefaultStrategy<J, std::string, double, int64_t, bool, std::nullptr_t>;
+
+using Json = Core::Json<std::string, type>;
+
+struct Measurement
+{
+    std::string Corpus;
+    std::string Operation;
+    std::size_t Bytes = 0;
+    std::size_t Operations = 0;
+    double MegabytesPerSecond = 0;
+    double NanosecondsPerOperation = 0;
+    double AllocationsPerOperation = 0;
+    double AllocatedBytesPerOperation = 0;
+};
+
+template <>
+struct Core::Describe<Measurement>
+{
+    constexpr static std::tuple Fields{Core::Field{"Corpus", &Measurement::Corpus}, Core::Field{"Operation", &Measurement::Operation},
+                                       Core::Field{"Bytes", &Measurement::Bytes}, Core::Field{"Operations", &Measurement::Operations},
+                                       Core::Field{"MBps", &Measurement::MegabytesPerSecond}, Core::Field{"NsPerOp", &Measurement::NanosecondsPerOperation},
+                                       Core::Field{"AllocationsPerOp", &Measurement::AllocationsPerOperation},
+                                       Core::Field{"AllocatedBytesPerOp", &Measurement::AllocatedBytesPerOperation}};
+};
+
+// Corpora, the same on every run and platform as only the raw output of the engine is used
+
+class Generator
+{
+public:
+    std::size_t Below(std::size_t Bound)
+    {
+        return Engine() % Bound;
+    }
+
+    std::string Word()
+    {
+        static constexpr char const *Words[] = {"alpha", "beta", "gamma", "delta", "json", "parser", "tape", "arena",
+                                                "index", "cursor", "stream", "token", "value", "object", "array", "string"};
+
+        return Words[Below(std::size(Words))];
+    }
+
+    std::string Sentence(std::size_t Count)
+    {
+        std::string Result;
+
+        for (std::size_t i = 0; i < Count; ++i)
+        {
+            Result += i ? " " : "";
+            Result += Word();
+
+            // Some escapes and characters outside of ASCII along the way
+
+            if (Below(16) == 0)
+                Result += "\\n";
+            else if (Below(16) == 0)
+                Result += "\\\"quoted\\\"";
+            else if (Below(16) == 0)
+                Result += "caf\xC3\xA9 \\u00e9";
+        }
+
+        return Result;
+    }
+
+private:
+    std::mt19937_64 Engine{20240601};
+};
+
+constexpr std::size_t Target = 4 * 1024 * 1024;
+
+std::string Twitter(Generator &Random)
+{
+    std::string Result = "{\"statuses\":[";
+
+    for (std::size_t i = 0; Result.size() < Target; ++i)
+    {
+        Result += i ? "," : "";
+        Result += "{\"id\":" + std::to_string(1000000000000000000 + Random.Below(1000000000)) +
+                  ",\"text\":\"" + Random.Sentence(8 + Random.Below(16)) +
+                  "\",\"created_at\":\"Sun Jun 02 12:" + std::to_string(10 + Random.Below(50)) + ":00 +0000 2024\"" +
+                  ",\"user\":{\"id\":" + std::to_string(Random.Below(100000000)) + ",\"screen_name\":\"" + Random.Word() +
+                  std::to_string(Random.Below(1000)) + "\",\"followers_count\":" + std::to_string(Random.Below(100000)) +
+                  ",\"verified\":" + (Random.Below(10) ? "false" : "true") + ",\"description\":" +
+                  (Random.Below(3) ? "\"" + Random.Sentence(6) + "\"" : "null") + "}" +
+                  ",\"retweet_count\":" + std::to_string(Random.Below(5000)) + ",\"favorited\":false" +
+                  ",\"coordinates\":" + (Random.Below(4) ? "null" : "[" + std::to_string(Random.Below(180)) + ".25," + std::to_string(Random.Below(90)) + ".5]") +
+                  ",\"entities\":{\"hashtags\":[\"" + Random.Word() + "\",\"" + Random.Word() + "\"],\"urls\":[]}}";
+    }
+
+    return Result + "]}";
+}
+
+std::string Deep(Generator &Random)
+{
+    std::string Result = "{\"trees\":[";
+
+    for (std::size_t i = 0; Result.size() < Target; ++i)
+    {
+        std::size_t Depth = 100 + Random.Below(400);
+
+        Result += i ? "," : "";
+
+        for (std::size_t Level = 0; Level < Depth; ++Level)
+            Result += Level % 2 ? "[" : "{\"n\":";
+
+        Result += std::to_string(i);
+
+        for (std::size_t Level = Depth; Level--;)
+            Result += Level % 2 ? "]" : "}";
+    }
+
+    return Result + "]}";
+}
+
+std::string Numbers(Generator &Random)
+{
+    std::string Result = "{\"numbers\":[";
+
+    for (std::size_t i = 0; Result.size() < Target; ++i)
+    {
+        Result += i ? "," : "";
+
+        switch (Random.Below(4))
+        {
+        case 0:
+            Result += std::to_string(Random.Below(1000000));
+            break;
+        case 1:
+            Result += "-" + std::to_string(Random.Below(1000000000000));
+            break;
+        case 2:
+            Result += std::to_string(Random.Below(100000)) + "." + std::to_string(Random.Below(1000000));
+            break;
+        default:
+            Result += std::to_string(Random.Below(10)) + "." + std::to_string(Random.Below(100000)) + "e" + std::to_string(int(Random.Below(40)) - 20);
+        }
+    }
+
+    return Result + "]}";
+}
+
+std::string Strings(Generator &Random)
+{
+    std::string Result = "{\"strings\":[";
+
+    for (std::size_t i = 0; Result.size() < Target; ++i)
+    {
+        Result += i ? "," : "";
+        Result += "\"" + Random.Sentence(100 + Random.Below(600)) + "\"";
+    }
+
+    return Result + "]}";
+}
+
+std::string Logs(Generator &Random)
+{
+    std::string Result;
+
+    for (std::size_t i = 0; Result.size() < Target; ++i)
+    {
+        Result += "{\"time\":" + std::to_string(1700000000 + i) + ",\"level\":\"" + (Random.Below(7) ? "info" : "warn") +
+                  "\",\"service\":\"" + Random.Word() + "\",\"latency\":" + std::to_string(Random.Below(1000)) +
+                  ".25,\"path\":\"/api/v1/items/" + std::to_string(Random.Below(100000)) + "\",\"tags\":[\"" + Random.Word() +
+                  "\"],\"cached\":" + (Random.Below(2) ? "true" : "false") + "}\n";
+    }
+
+    return Result;
+}
+
+// Paths taken at random from the root down to a scalar, keys and indices
+
+using Step = std::variant<std::string, std::size_t>;
+
+std::vector<Step> Walk(Json &Root, Generator &Random)
+{
+    std::vector<Step> Path;
+
+    auto &Members = Root.GetMap();
+    auto Member = std::next(Members.begin(), Random.Below(Members.size()));
+
+    Path.push_back(Member->first);
+
+    auto *Node = &Member->second;
+
+    while (true)
+    {
+        if (Node->Is<Json>() && !Node->As<Json>().GetMap().empty())
+        {
+            auto &Map = Node->As<Json>().GetMap();
+            auto Next = std::next(Map.begin(), Random.Below(Map.size()));
+
+            Path.push_back(Next->first);
+            Node = &Next->second;
+        }
+        else if (Node->Is<Json::Array>() && !Node->As<Json::Array>().empty())
+        {
+            auto &Items = Node->As<Json::Array>();
+            std::size_t Index = Random.Below(Items.size());
+
+            Path.push_back(Index);
+            Node = &Items[Index];
+        }
+        else
+        {
+            return Path;
+        }
+    }
+}
+
+Json::Value &Follow(Json &Root, std::vector<Step> const &Path)
+{
+    auto *Node = &Root[std::get<std::string>(Path.front())];
+
+    for (std::size_t i = 1; i < Path.size(); ++i)
+    {
+        if (auto Key = std::get_if<std::string>(&Path[i]))
+            Node = &static_cast<Json::Value &>((*Node)[*Key]);
+        else
+            Node = &static_cast<Json::Value &>((*Node)[std::get<std::size_t>(Path[i])]);
+    }
+
+    return *Node;
+}
+
+// Time and allocations summed over the intervals between Begin and End. Measure calls them
+// around the whole function, which can call them itself to leave its setup or teardown out.
+
+class Timer
+{
+public:
+    void Begin()
+    {
+        Allocations = HeapAllocations;
+        Allocated = HeapBytes;
+        Start = std::chrono::steady_clock::now();
+        Running = true;
+    }
+
+    void End()
+    {
+        if (!Running)
+            return;
+
+        Seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+        TotalAllocations += HeapAllocations - Allocations;
+        TotalAllocated += HeapBytes - Allocated;
+        Running = false;
+    }
+
+    double Seconds = 0;
+    std::size_t TotalAllocations = 0;
+    std::size_t TotalAllocated = 0;
+
+private:
+    std::chrono::steady_clock::time_point Start;
+    std::size_t Allocations = 0;
+    std::size_t Allocated = 0;
+    bool Running = false;
+};
+
+// Runs Function(Count, Clock) with Count growing until a run lasts long enough to be measured
+
+static volatile std::size_t Sink;
+
+template <typename F>
+Measurement Measure(std::string_view Corpus, std::string_view Operation, std::size_t Bytes, F &&Function)
+{
+    for (std::size_t Count = 1;; Count *= 2)
+    {
+        Timer Clock;
+
+        Clock.Begin();
+
+        std::size_t Operations = Function(Count, Clock);
+
+        Clock.End();
+
+        if (Clock.Seconds > 0.25 || Count >= (std::size_t{1} << 20))
+        {
+            Measurement Measured;
+
+            Measured.Corpus = Corpus;
+            Measured.Operation = Operation;
+            Measured.Bytes = Bytes;
+            Measured.Operations = Operations;
+            Measured.MegabytesPerSecond = Bytes ? Bytes * double(Count) / Clock.Seconds / 1e6 : 0;
+            Measured.NanosecondsPerOperation = Clock.Seconds / Operations * 1e9;
+            Measured.AllocationsPerOperation = double(Clock.TotalAllocations) / Operations;
+            Measured.AllocatedBytesPerOperation = double(Clock.TotalAllocated) / Operations;
+
+            return Measured;
+        }
+    }
+}
+
+void Report(Measurement const &Measured)
+{
+    std::printf("%s\n", Core::Serialize(Measured).c_str());
+    std::fprintf(stderr, "%-10s %-12s %10.1f MB/s %14.1f ns/op %12.1f allocs/op\n", Measured.Corpus.c_str(), Measured.Operation.c_str(),
+                 Measured.MegabytesPerSecond, Measured.NanosecondsPerOperation, Measured.AllocationsPerOperation);
+}
+
+// Documents are parsed once per operation, records once per line
+
+std::vector<Json> Parse(std::string_view Text, bool Lines)
+{
+    std::vector<Json> Documents;
+
+    if (Lines)
+        Core::NdJson::Records(Text, [&](std::string_view Record)
+                              { Documents.push_back(Json::From(Record)); });
+    else
+        Documents.push_back(Json::From(Text));
+
+    return Documents;
+}
+
+void Run(std::string_view Name, std::string const &Text, bool Lines)
+{
+    Generator Random;
+
+    std::size_t Records = Parse(Text, Lines).size();
+
+    // Destruction is left out of the parse time, and copying of the destruction time
+
+    Report(Measure(Name, "parse", Text.size(), [&](std::size_t Count, Timer &Clock)
+                   {
+                       for (std::size_t i = 0; i < Count; ++i)
+                       {
+                           Clock.Begin();
+
+                           auto Kept = Parse(Text, Lines);
+
+                           Clock.End();
+                       }
+
+                       return Count * Records; }));
+
+    auto Documents = Parse(Text, Lines);
+
+    Report(Measure(Name, "serialize", Text.size(), [&](std::size_t Count, Timer &)
+                   {
+                       std::size_t Size = 0;
+
+                       for (std::size_t i = 0; i < Count; ++i)
+                       {
+                           for (auto const &Document : Documents)
+                               Size += Core::Serialize(Document).size();
+                       }
+
+                       Sink = Size;
+
+                       return Count * Documents.size(); }));
+
+    std::vector<std::pair<std::size_t, std::vector<Step>>> Paths;
+
+    for (std::size_t i = 0; i < 4096; ++i)
+    {
+        std::size_t Document = Random.Below(Documents.size());
+
+        Paths.emplace_back(Document, Walk(Documents[Document], Random));
+    }
+
+    Report(Measure(Name, "access", 0, [&](std::size_t Count, Timer &)
+                   {
+                       std::size_t Found = 0;
+
+                       for (std::size_t i = 0; i < Count; ++i)
+                       {
+                           for (auto const &[Document, Path] : Paths)
+                               Found += Follow(Documents[Document], Path).Index();
+                       }
+
+                       Sink = Found;
+
+                       return Count * Paths.size(); }));
+
+    Report(Measure(Name, "destroy", Text.size(), [&](std::size_t Count, Timer &Clock)
+                   {
+                       for (std::size_t i = 0; i < Count; ++i)
+                       {
+                           auto Kept = Documents;
+
+                           Clock.Begin();
+
+                           Kept.clear();
+
+                           Clock.End();
+                       }
+
+                       return Count * Records; }));
+}
+
+int main(int Count, char const *Arguments[])
+{
+    std::string_view Filter = Count > 1 ? Arguments[1] : "";
+
+    Generator Random;
+
+    struct Corpus
+    {
+        std::string_view Name;
+        std::string Text;
+        bool Lines;
+    };
+
+    Corpus Corpora[] = {{"twitter", Twitter(Random), false},
+                        {"deep", Deep(Random), false},
+                        {"numbers", Numbers(Random), false},
+                        {"strings", Strings(Random), false},
+                        {"ndjson", Logs(Random), true}};
+
+    for (auto const &Item : Corpora)
+    {
+        if (Item.Name.find(Filter) != std::string_view::npos)
+            Run(Item.Name, Item.Text, Item.Lines);
+    }
+
+    return 0;
+}
@@ -0,0 +1,180 @@
+#include <string>
+#include <cstdio>
+#include <Core/Format/Json.hpp>
+#include <Core/Format/Json/Tape.hpp>
+#include <Core/Format/Json/Writer.hpp>
+#include <Core/Format/Json/Validate.hpp>
+#include "Benchmark.hpp"
+
+// Memory per node, parse and traversal speed of the tape against the Recursive tree. The tree
+// is parsed into an arena so every byte it allocates is accounted for.
+
+template <typename J>
+using type = Core::DefaultStrategy<J, std::string_view, double, int64_t, bool, std::nullptr_t>;
+
+using Json = Core::Json<std::string_view, type, std::pmr::map, std::pmr::vector>;
+
+std::string Catalog()
+{
+    std::string Result = "{\"Items\":[";
+
+    for (std::size_t i = 0; Result.size() < 4 * 1024 * 1024; ++i)
+    {
+        Result += i ? "," : "";
+        Result += "{\"Id\":" + std::to_string(i) + ",\"Name\":\"item " + std::to_string(i) +
+                  "\",\"Price\":" + std::to_string(i % 100) + ".5,\"Stock\":" + std::to_string(i % 17) +
+                  ",\"Tags\":[\"new\",\"sale\"],\"Active\":true,\"Parent\":null}";
+    }
+
+    return Result + "]}";
+}
+
+// Counts the values of the document, keys excluded
+
+struct Counter
+{
+    std::size_t Nodes = 0;
+
+    void StartObject() { ++Nodes; }
+    void StartArray() { ++Nodes; }
+    void EndObject() {}
+    void EndArray() {}
+    void Key(std::string_view) {}
+    void String(std::string_view) { ++Nodes; }
+    void Integer(std::int64_t) { ++Nodes; }
+    void Double(double) { ++Nodes; }
+    void Boolean(bool) { ++Nodes; }
+    void Null() { ++Nodes; }
+};
+
+// Sums every integer of the document by visiting all of its values
+
+std::int64_t Sum(Json::Value const &Value)
+{
+    return Value.Visit(
+        [](auto const &arg) -> std::int64_t
+        {
+            using TArg = std::decay_t<decltype(arg)>;
+
+            std::int64_t Result = 0;
+
+            if constexpr (std::is_same_v<TArg, Json>)
+            {
+                for (auto const &[Key, Member] : arg.GetMap())
+                    Result += Sum(Member);
+            }
+            else if constexpr (std::is_same_v<TArg, Json::Array>)
+            {
+                for (auto const &Item : arg)
+                    Result += Sum(Item);
+            }
+            else if constexpr (std::is_same_v<TArg, std::int64_t>)
+            {
+                Result = arg;
+            }
+
+            return Result;
+        });
+}
+
+std::int64_t Sum(Core::Tape::Value Value)
+{
+    return Value.Visit(
+        [](auto arg) -> std::int64_t
+        {
+            using TArg = decltype(arg);
+
+            std::int64_t Result = 0;
+
+            if constexpr (std::is_same_v<TArg, Core::Tape::Object>)
+            {
+                for (auto [Key, Member] : arg)
+                    Result += Sum(Member);
+            }
+            else if constexpr (std::is_same_v<TArg, Core::Tape::Array>)
+            {
+                for (auto Item : arg)
+                    Result += Sum(Item);
+            }
+            else if constexpr (std::is_same_v<TArg, std::int64_t>)
+            {
+                Result = arg;
+            }
+
+            return Result;
+        });
+}
+
+// Every prefix of a document, and the document with a bad escape, keeps what was parsed
+// before the error. Walking that tape has to stay within it and print valid Json, which a
+// key left without its value would not be.
+
+bool Truncated()
+{
+    std::string Document = R"({"a":{"b":[1,"x\ty",{"c":null}],"d\n":"e"},"f":"\u00e9","g":true})";
+
+    auto Check = [](std::string_view Input)
+    {
+        auto Flat = Core::Tape::From(Input);
+
+        return !Core::Validate(Core::Serialize(Flat.Root())).Failed();
+    };
+
+    for (std::size_t Size = 0; Size <= Document.size(); ++Size)
+    {
+        if (!Check(std::string_view(Document).substr(0, Size)))
+        {
+            std::printf("invalid tape for %.*s\n", static_cast<int>(Size), Document.c_str());
+            return false;
+        }
+    }
+
+    return Check(R"({"a":"\q","b":1})") && Check(R"({"a":{"b":"\u12"}})");
+}
+
+int main(int, char const *[])
+{
+    if (!Truncated())
+        return 1;
+
+    auto Input = Catalog();
+
+    Counter Values;
+    Core::Sax::Parse(Input, Values);
+
+    std::printf("%zu bytes, %zu values\n", Input.size(), Values.Nodes);
+
+    Core::Arena Memory;
+    Json::Value Tree{Json::From(Input, &Memory)};
+    auto Flat = Core::Tape::From(Input);
+
+    std::printf("tree   %8.1f bytes per value\n", double(Memory.BytesAllocated()) / Values.Nodes);
+    std::printf("tape   %8.1f bytes per value\n", double(Flat.GetWords().capacity() * sizeof(std::uint64_t)) / Values.Nodes);
+
+    double TreeParse = Measure([&]
+                               {
+                                   Core::Arena Scratch{Input.size() * 4};
+                                   Json::From(Input, &Scratch); },
+                               10);
+
+    double TapeParse = Measure([&]
+                               { Core::Tape::From(Input); },
+                               10);
+
+    std::printf("parse      tree %8.1f MB/s  tape %8.1f MB/s\n", Input.size() / TreeParse / 1e6, Input.size() / TapeParse / 1e6);
+
+    std::int64_t TreeSum = 0, TapeSum = 0;
+
+    double TreeWalk = Measure([&]
+                              { TreeSum = Sum(Tree); },
+                              10);
+
+    double TapeWalk = Measure([&]
+                              { TapeSum = Sum(Flat.Root()); },
+                              10);
+
+    std::printf("traversal  tree %8.2f ms    tape %8.2f ms    (sums %lld, %lld)\n",
+                TreeWalk * 1e3, TapeWalk * 1e3, static_cast<long long>(TreeSum), static_cast<long long>(TapeSum));
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include <string>
+#include <cstdio>
+#include <Core/Format/Json.hpp>
+#include <Core/Format/Json/Validate.hpp>
+#include "Benchmark.hpp"
+
+// Checking documents without keeping them, through Validate, Sax::Parse with a handler that
+// ignores every event and Json::From, on records with strings, escapes and non ASCII text.
+// Every document is also broken in a few ways to check the three agree.
+
+template <typename J>
+using type = Core::DefaultStrategy<J, std::string, double, int64_t, bool, std::nullptr_t>;
+
+using Json = Core::Json<std::string, type>;
+
+struct Ignore
+{
+    void StartObject() {}
+    void EndObject() {}
+    void StartArray() {}
+    void EndArray() {}
+    void Key(std::string_view) {}
+    void String(std::string_view) {}
+    void Integer(std::int64_t) {}
+    void Double(double) {}
+    void Boolean(bool) {}
+    void Null() {}
+};
+
+// Stops on the first scalar, which parsing has to report as a stop rather than a bad number
+
+struct Stop : Ignore
+{
+    bool Integer(std::int64_t) { return false; }
+    bool Double(double) { return false; }
+    bool Boolean(bool) { return false; }
+    bool Null() { return false; }
+};
+
+bool Stops()
+{
+    using enum Core::Error;
+
+    for (auto [Input, Expected] : {std::pair<std::string_view, Core::Error>{"[1]", Stopped}, {"[1.5]", Stopped}, {"[true]", Stopped},
+                                   {"[null]", Stopped}, {"[nan]", Number}, {"[01]", Number}, {"[1e400]", Number}})
+    {
+        Stop Handler;
+        Core::Status Failure;
+
+        if (Core::Sax::Parse(Input, Handler, Failure) || Failure.Code != Expected)
+        {
+            std::printf("%.*s reported as %s\n", static_cast<int>(Input.size()), Input.data(), Core::Message(Failure.Code));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::string Records(std::size_t Count)
+{
+    std::string Result = "{\"Records\":[";
+
+    for (std::size_t i = 0; i < Count; ++i)
+    {
+        Result += i ? "," : "";
+        Result += "{\"Id\":" + std::to_string(i) + ",\"Name\":\"record \\\"" + std::to_string(i) +
+                  "\\\"\",\"City\":\"Z\xC3\xBCrich\",\"Score\":" + std::to_string(i % 100) +
+                  ".5e-1,\"Tags\":[\"a\",\"b\",true,null],\"Text\":\"" + std::string(40 + i % 50, 'x') + "\"}";
+    }
+
+    return Result + "]}";
+}
+
+bool Parses(std::string_view Input)
+{
+    Ignore Handler;
+
+    return Core::Sax::Parse(Input, Handler);
+}
+
+int main(int, char const *[])
+{
+    if (!Stops())
+        return 1;
+
+    auto Input = Records(100000);
+
+    bool Valid = !Core::Validate(Input).Failed();
+
+    double Validate = Measure<std::nano>([&]
+                                         { Valid &= !Core::Validate(Input).Failed(); },
+                                         10);
+
+    double Events = Measure<std::nano>([&]
+                                       { Valid &= Parses(Input); },
+                                       10);
+
+    double Build = Measure<std::nano>([&]
+                                      { Valid &= bool(Json::TryFrom(Input)); },
+                                      5);
+
+    std::printf("%zu bytes\n", Input.size());
+    std::printf("Validate         %8.1f MB/s\n", Input.size() / Validate * 1e3);
+    std::printf("Sax::Parse       %8.1f MB/s  %.1fx\n", Input.size() / Events * 1e3, Events / Validate);
+    std::printf("Json::TryFrom    %8.1f MB/s  %.1fx\n", Input.size() / Build * 1e3, Build / Validate);
+
+    // A trailing comma, a bad escape, invalid UTF-8, a control character and a cut document
+
+    std::string Broken[] = {Input, Input, Input, Input, Input.substr(0, Input.size() / 2)};
+    std::size_t Middle = Input.size() / 2;
+
+    Broken[0].replace(Broken[0].find("]", Middle), 1, ",]");
+    Broken[1].replace(Broken[1].find("\\\"", Middle), 2, "\\x");
+    Broken[2].replace(Broken[2].find("\xC3", Middle), 1, "\xFF");
+    Broken[3].replace(Broken[3].find("xxx", Middle), 1, "\t");
+
+    for (auto const &Document : Broken)
+        Valid &= Core::Validate(Document).Failed() && !Parses(Document) && !Json::TryFrom(Document);
+
+    if (!Valid)
+    {
+        std::printf("mismatch\n");
+        return 1;
+    }
+
+    return 0;
+}
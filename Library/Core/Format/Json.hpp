@@ -1,12 +1,25 @@
+#pragma once
+
 #include <variant>
 #include <optional>
 #include <map>
 #include <vector>
 #include <string>
+#include <utility>
+#include <algorithm>
 #include <iostream>
 #include <type_traits>
-#include <ranges>
 #include <charconv>
+#include <memory_resource>
+
+#include "Json/Structural.hpp"
+#include "Json/Escape.hpp"
+#include "Json/Sax.hpp"
+#include "Json/Map.hpp"
+#include "Json/Symbol.hpp"
+#include "Json/Arena.hpp"
+#include "Json/Statistics.hpp"
+#include "Json/Result.hpp"
 
 #define STRINGIFY(...) (#__VA_ARGS__)
 
@@ -62,9 +75,25 @@ struct Contains
     static constexpr bool value{(std::is_same_v<T, Args> || ...)};
 };
 
+// Builds a container on the given resource when it is allocator aware, or a plain one otherwise
+
+template <typename TContainer, typename... TArgs>
+constexpr TContainer Allocate(std::pmr::memory_resource *Resource, TArgs &&...Args)
+{
+    if constexpr (std::is_constructible_v<TContainer, TArgs..., std::pmr::memory_resource *>)
+        return TContainer(std::forward<TArgs>(Args)..., Resource);
+    else
+        return TContainer(std::forward<TArgs>(Args)...);
+}
+
+constexpr static bool IsSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
 constexpr static void Skip(std::string_view sv, std::size_t &Index)
 {
-    while (Index < sv.length() && (sv[Index] == ' ' || sv[Index] == '\n'))
+    while (Index < sv.length() && IsSpace(sv[Index]))
         Index++;
 }
 
@@ -75,7 +104,7 @@ namespace Core
     {
     public:
         using Json = T;
-        using Array = std::vector<typename T::Value>;
+        using Array = typename T::Array;
         using Value = std::variant<T, Array, TO...>;
 
         constexpr Recursive() = default;
@@ -189,22 +218,90 @@ namespace Core
             return Item.index();
         }
 
+        // Lookups that neither throw nor insert, nullptr when the value isn't an object or an
+        // array or has no such member or element
+
+        constexpr Recursive *Find(typename Json::Key const &Key)
+        {
+            return const_cast<Recursive *>(std::as_const(*this).Find(Key));
+        }
+
+        constexpr Recursive const *Find(typename Json::Key const &Key) const
+        {
+            auto Object = std::get_if<T>(&Item);
+
+            if (!Object)
+                return nullptr;
+
+            auto It = Object->GetMap().find(Key);
+
+            return It != Object->GetMap().end() ? &It->second : nullptr;
+        }
+
+        constexpr Recursive *Find(std::size_t Index)
+        {
+            return const_cast<Recursive *>(std::as_const(*this).Find(Index));
+        }
+
+        constexpr Recursive const *Find(std::size_t Index) const
+        {
+            auto Items = std::get_if<Array>(&Item);
+
+            return Items && Index < Items->size() ? &(*Items)[Index] : nullptr;
+        }
+
+        // nullptr when the value holds another type
+
+        template <typename Target>
+        constexpr Target *TryAs()
+        {
+            return std::get_if<Target>(&Item);
+        }
+
+        template <typename Target>
+        constexpr Target const *TryAs() const
+        {
+            return std::get_if<Target>(&Item);
+        }
+
+        // The member Key when there is one holding a Target
+
+        template <typename Target>
+        constexpr std::optional<Target> TryGet(typename Json::Key const &Key) const
+        {
+            if (auto Member = Find(Key))
+            {
+                if (auto Value = Member->template TryAs<Target>())
+                    return *Value;
+            }
+
+            return std::nullopt;
+        }
+
     protected:
         Value Item;
     };
 
-    template <typename TKey, template <typename> typename TValue>
+    template <typename TKey, template <typename> typename TValue, template <typename, typename> typename TMap = std::map, template <typename> typename TArray = std::vector>
         requires(std::is_constructible_v<TKey, char const *> && std::is_constructible_v<TKey, const char (&)[]> && std::is_constructible_v<TKey, std::string_view>)
     struct Json
     {
         using Key = TKey;
         using Value = TValue<Json>;
-        using Map = std::map<TKey, Value>;
+        using Map = TMap<TKey, Value>;
         using Pair = std::pair<TKey, Value>;
-        using Array = std::vector<Value>;
+        using Array = TArray<Value>;
 
         constexpr Json() = default;
 
+        // Only available when the storages are allocator aware, e.g. std::pmr::map and std::pmr::vector
+
+        explicit Json(std::pmr::memory_resource *Resource)
+            requires(std::is_constructible_v<Map, std::pmr::memory_resource *>)
+            : Data(Resource)
+        {
+        }
+
         constexpr Json(std::initializer_list<Pair> list)
         {
             for (auto const &Item : list)
@@ -233,6 +330,31 @@ namespace Core
             return Data[key];
         }
 
+        // Lookups that neither throw nor insert, see Recursive::Find
+
+        constexpr Value *Find(TKey const &Key)
+        {
+            auto It = Data.find(Key);
+
+            return It != Data.end() ? &It->second : nullptr;
+        }
+
+        constexpr Value const *Find(TKey const &Key) const
+        {
+            auto It = Data.find(Key);
+
+            return It != Data.end() ? &It->second : nullptr;
+        }
+
+        template <typename Target>
+        constexpr std::optional<Target> TryGet(TKey const &Key) const
+        {
+            if (auto Member = Find(Key); Member && Member->template Is<Target>())
+                return Member->template As<Target>();
+
+            return std::nullopt;
+        }
+
         constexpr auto &GetMap()
         {
             return Data;
@@ -243,121 +365,146 @@ namespace Core
             return Data;
         }
 
-        constexpr static Json From(std::string_view sv)
+        static Json From(std::string_view sv, std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
         {
-            Json Result;
+            auto Result = Allocate<Json>(Resource);
 
-            From(Result, sv);
+            From(Result, sv, Resource);
 
             return Result;
         }
 
-        constexpr static std::string_view Trim(std::string_view str)
+        // Same, filling Stats in along the way, see Statistics
+
+        static Json From(std::string_view sv, Statistics &Stats, std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
         {
-            // Trim leading white spaces
-            auto trimmed_start_view = str | std::ranges::views::drop_while([](char c)
-                                                                           { return std::isspace(static_cast<unsigned char>(c)); });
+            if constexpr (!Statistics::Enabled)
+                return From(sv, Resource);
+
+            auto Result = Allocate<Json>(Resource);
+            auto Start = Statistics::Scope::Clock::now();
 
-            // Convert to string_view after trimming leading spaces
-            std::string_view trimmed_start{trimmed_start_view.begin(), static_cast<std::string_view::size_type>(trimmed_start_view.size())};
+            Structural::Index Positions{sv};
+            Structural::Cursor Cursor{Positions};
 
-            // Trim trailing white spaces
-            auto reversed_view = std::ranges::views::reverse(trimmed_start);
-            auto trimmed_reversed_view = reversed_view | std::ranges::views::drop_while([](char c)
-                                                                                        { return std::isspace(static_cast<unsigned char>(c)); });
+            Stats.Indexing += Statistics::Scope::Clock::now() - Start;
 
-            // // Since these are reverse iterators, we need to get the base iterators and adjust
-            return {trimmed_reversed_view.begin().base(), static_cast<std::string_view::size_type>(trimmed_reversed_view.size())};
+            if (auto Root = Value::From(Cursor, Stats, Resource); Root.template Is<Json>())
+                Result = std::move(Root.template As<Json>());
+
+            return Result;
         }
 
-        inline constexpr static void From(Json &Object, std::string_view sv)
+        // Parses sv without throwing or keeping what was parsed before an error, a root other
+        // than an object being an Error::Type
+
+        static Result<Json> TryFrom(std::string_view sv, std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
         {
-            Pairs(Object, Trim(sv));
+            auto Root = Value::TryFrom(sv, Resource);
+
+            if (!Root)
+                return Root.GetStatus();
+
+            if (!Root->template Is<Json>())
+                return Status{Error::Type, std::min(sv.find_first_not_of(" \t\r\n"), sv.size())};
+
+            return std::move(Root->template As<Json>());
         }
 
-        constexpr bool operator==(Json const &Other) const
+        inline static void From(Json &Object, std::string_view sv, std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
         {
-            return Data == Other.Data;
+            Structural::Index Positions{sv};
+            Structural::Cursor Cursor{Positions};
+
+            if (auto Root = Value::From(Cursor, Resource); Root.template Is<Json>())
+                Object = std::move(Root.template As<Json>());
         }
 
-        template <typename TSerializer>
-        friend TSerializer &operator<<(TSerializer &os, Json const &json)
+        // Parses the object the cursor points at ('{') one member at a time through Value::From,
+        // leaving the cursor right after its closing '}'. Meant for strategies that want to
+        // control how each member is parsed, nested containers are allocated from Resource.
+
+        static void Pairs(Json &Object, Structural::Cursor &Cursor, std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
         {
+            if (Cursor.Peek() != '{')
+                return;
 
-            os << '{';
+            Cursor.Next();
 
-            bool firstPair = true;
-            for (const auto &pair : json.GetMap())
+            if (Cursor.Peek() == '}')
             {
-                if (!firstPair)
-                {
-                    os << ",";
-                }
-                os << "\"" << pair.first << "\"" << ":" << pair.second;
-
-                firstPair = false;
+                Cursor.Next();
+                return;
             }
 
-            os << '}';
+            while (Cursor.Peek() == '"')
+            {
+                auto Raw = Cursor.String();
+                auto Escaped = Escape::Classify(Raw, Cursor);
+                auto Key = Escape::Make<TKey>(Raw, Escaped, Resource);
 
-            return os;
-        }
+                if (!Key)
+                    Escape::Require<TKey>(Raw, Escaped == Escape::Kind::Escaped, Resource);
 
-    protected:
-        Map Data;
+                if (!Key || Cursor.Peek() != ':')
+                {
+                    Cursor.Finish();
+                    break;
+                }
 
-        constexpr static std::string_view OneKey(std::string_view sv, std::size_t &Index)
-        {
-            if (Index >= sv.size())
-                return "";
+                Cursor.Next();
 
-            std::size_t StartIndex = Index;
-            std::size_t EndIndex = 0;
+                Object.Insert(std::move(*Key), Value::From(Cursor, Resource));
 
-            while (StartIndex < sv.length() && sv[StartIndex] != '"')
-            {
-                StartIndex++;
-            }
+                if (Cursor.Peek() != ',')
+                {
+                    // Either the closing brace or malformed input, stop in both cases
 
-            StartIndex = Index;
+                    if (Cursor.Peek() == '}')
+                        Cursor.Next();
 
-            while (Index < sv.length() && sv[Index] != ':')
-            {
-                if (sv[Index] == '"')
-                    EndIndex = Index;
+                    break;
+                }
 
-                Index++;
+                Cursor.Next();
             }
+        }
 
-            if (Index >= sv.length())
-                return "";
-
-            ++Index;
-            return sv.substr(StartIndex + 1, EndIndex - StartIndex - 1);
+        constexpr bool operator==(Json const &Other) const
+        {
+            return Data == Other.Data;
         }
 
-        constexpr static void Pairs(Json &Object, std::string_view sv)
+        template <typename TSerializer>
+        friend TSerializer &operator<<(TSerializer &os, Json const &json)
         {
-            if (sv.size() == 0)
-                return;
 
-            std::size_t Index = 0;
+            os << '{';
 
-            while (Index < sv.size())
+            bool firstPair = true;
+            for (const auto &pair : json.GetMap())
             {
-                std::string_view Key;
-
-                Skip(sv, Index);
+                if (!firstPair)
+                {
+                    os << ",";
+                }
+                os << '"';
 
-                if (Key = OneKey(sv, Index); !Index)
-                    break;
+                Escape::Encode(std::string_view(pair.first), [&](std::string_view Piece)
+                               { os << Piece; });
 
-                Skip(sv, Index);
+                os << "\":" << pair.second;
 
-                if (Object.Insert(TKey{Key}, Value::From(sv, Index)); !Index)
-                    break;
+                firstPair = false;
             }
+
+            os << '}';
+
+            return os;
         }
+
+    protected:
+        Map Data;
     };
 
     template <typename T, typename... TO>
@@ -434,152 +581,266 @@ namespace Core
             return std::nullopt;
         }
 
-        constexpr static DefaultStrategy From(std::string_view sv, std::size_t &Index, char Stop = '}')
+        // Parses the single value starting at sv[Index] and leaves Index right after it
+
+        static DefaultStrategy From(std::string_view sv, std::size_t &Index, std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
         {
-            if (sv.length() == 0)
-                return "";
+            Structural::Index Positions{sv.substr(Index)};
+            Structural::Cursor Cursor{Positions};
+
+            auto Result = From(Cursor, Resource);
+
+            Index += Cursor.Offset();
+
+            return Result;
+        }
 
-            char OT = sv[Index];
+        // Builds the tree out of the events of the Sax parser, objects and arrays being built
+        // are kept on a stack and moved into their parent once closed. Strings are decoded
+        // straight into their final storage, see Escape::Make. TValue is the strategy the
+        // tree is made of, another one holding the same types may reuse it, see Compact.hpp.
 
-            std::size_t StartIndex = 0;
-            std::size_t EndIndex = 0;
+        template <typename TValue>
+        class Building
+        {
+        public:
+            constexpr static bool Decode = false;
 
-            if (OT == '"')
+            explicit Building(std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
+                : Resource(Resource), Frames(Resource)
             {
-                StartIndex = Index;
-                while (Index < sv.length() && ((sv[Index] != ',' && sv[Index] != Stop) || !EndIndex))
-                {
-                    if (sv[Index] == '"')
-                        EndIndex = Index;
+            }
 
-                    Index++;
-                };
+            void StartObject()
+            {
+                Frames.push_back({Make(Allocate<T>(Resource)), std::move(PendingKey)});
+            }
 
-                if (Index >= sv.length())
-                    return "";
+            void StartArray()
+            {
+                Frames.push_back({Make(Allocate<typename T::Array>(Resource)), std::move(PendingKey)});
+            }
 
-                Index++;
+            void EndObject()
+            {
+                Close();
+            }
 
-                return typename FirstWhere<is_string, TO...>::type{sv.substr(StartIndex + 1, EndIndex - StartIndex - 1)};
+            void EndArray()
+            {
+                Close();
             }
-            else if (OT == '{')
+
+            bool Key(std::string_view Raw, bool Escaped)
             {
-                std::size_t Count = 0;
+                auto Key = Escape::Make<typename T::Key>(Raw, Escaped, Resource);
 
-                StartIndex = Index;
-                while (Index < sv.length() && (Count | (sv[Index] != ',' && sv[Index] != Stop)))
-                {
-                    if (sv[Index] == '{')
-                    {
-                        Count++;
-                    }
-                    else if (sv[Index] == '}')
-                    {
-                        Count--;
-                        EndIndex = Index;
-                    }
+                if (Key)
+                    PendingKey.emplace(std::move(*Key));
+                else
+                    Refused |= Escape::Refuses<typename T::Key>(Raw, Escaped, Resource);
 
-                    Index++;
-                };
+                return Key.has_value();
+            }
 
-                if (Index > sv.length())
-                    return "";
+            bool String(std::string_view Raw, bool Escaped)
+            {
+                using Text = typename FirstWhere<is_string, TO...>::type;
+
+                auto Value = Escape::Make<Text>(Raw, Escaped, Resource);
 
-                Index++;
+                if (Value)
+                    Add(Make(std::move(*Value)), PendingKey);
+                else
+                    Refused |= Escape::Refuses<Text>(Raw, Escaped, Resource);
 
-                T Value;
+                return Value.has_value();
+            }
 
-                T::From(Value, sv.substr(StartIndex, EndIndex - StartIndex + 1));
+            void Integer(std::int64_t Value)
+            {
+                Add(Make(Value), PendingKey);
+            }
 
-                return Value;
+            void Double(double Value)
+            {
+                Add(Make(Value), PendingKey);
             }
-            else if (OT == '[')
+
+            // Only with Core::Number among the types, which then receives every number
+
+            void Number(Core::Number Value)
+                requires(Contains<Core::Number, TO...>::value)
             {
-                std::size_t Count = 1;
+                Add(Make(Value), PendingKey);
+            }
 
-                StartIndex = Index++;
-                while (Index < sv.length() && (Count | (sv[Index] != ',' && sv[Index] != Stop)))
-                {
-                    if (sv[Index] == '[')
-                    {
-                        Count++;
-                    }
-                    else if (sv[Index] == ']')
-                    {
-                        Count--;
-                        EndIndex = Index;
-                    }
+            void Boolean(bool Value)
+            {
+                Add(Make(typename FirstWhere<is_bool, TO...>::type{Value}), PendingKey);
+            }
 
-                    Index++;
-                };
+            void Null()
+            {
+                Add(Make(typename FirstWhere<is_null, TO...>::type{nullptr}), PendingKey);
+            }
 
-                if (Index > sv.length())
-                    return "";
+            // Parses the value the cursor points at into a TValue. These are the From and
+            // TryFrom of every strategy built this way. Malformed input keeps what was parsed
+            // before the error while strings Escape::Make refuses throw, see Escape::Refuses.
 
-                // @todo Handle the case when the last ite4m in list also has "," after it like : [1,2,]
+            static TValue Parse(Structural::Cursor &Cursor, std::pmr::memory_resource *Resource)
+            {
+                Building Handler{Resource};
 
-                auto ValueView = sv.substr(StartIndex + 1, EndIndex - StartIndex - 1);
-                typename T::Array Value;
+                Sax::Value(Cursor, Handler);
 
-                std::size_t tmpIndex = 0;
+                return Handler.Finish(true);
+            }
 
-                while (tmpIndex < ValueView.size())
-                {
-                    Skip(ValueView, tmpIndex);
+            // Same, filling Stats in, see Statistics. Every From taking a cursor and Stats comes
+            // here, so they all count the document, its bytes, allocations and building time.
 
-                    if (Value.insert(Value.end(), From(ValueView, tmpIndex, ']')); !tmpIndex)
-                        break;
-                }
+            static TValue Parse(Structural::Cursor &Cursor, Statistics &Stats, std::pmr::memory_resource *Resource)
+            {
+                if constexpr (!Statistics::Enabled)
+                    return Parse(Cursor, Resource);
+
+                Statistics::Scope Timing{Stats, Cursor, Resource};
+                Building Inner{Resource};
+                Instrumented<Building, typename T::Key, typename FirstWhere<is_string, TO...>::type> Handler{Inner, Stats, Resource};
 
-                Index++;
+                Sax::Value(Cursor, Handler);
+
+                return Inner.Finish(true);
+            }
+
+            // Same, reporting what went wrong and where in Failure. The builder only stops on
+            // strings it can't decode, which is what a stop gets reported as.
+
+            static TValue Parse(Structural::Cursor &Cursor, Status &Failure, std::pmr::memory_resource *Resource)
+            {
+                Building Handler{Resource};
+
+                if (!Sax::Value(Cursor, Handler, Failure) && Failure.Code == Error::Stopped)
+                    Failure.Code = Error::String;
+
+                return Handler.Finish();
+            }
+
+            // Parses the whole of sv, which has to hold exactly one value, without throwing.
+            // Inputs too large to index are an Error::Size.
+
+            static Core::Result<TValue> TryParse(std::string_view sv, std::pmr::memory_resource *Resource)
+            {
+                if (sv.size() > Structural::MaxSize)
+                    return Status{Error::Size, Structural::MaxSize};
+
+                Structural::Index Positions{sv};
+                Structural::Cursor Cursor{Positions};
+
+                Status Failure;
+
+                auto Value = Parse(Cursor, Failure, Resource);
+
+                if (!Failure.Failed() && !Cursor.End())
+                    Failure = {Error::Trailing, Cursor.Offset()};
+
+                if (Failure.Failed())
+                    return Failure;
 
                 return Value;
             }
-            else
+
+            // Returns the parsed value, containers left open by malformed input are closed
+            // so whatever was parsed before the error is kept. Strict throws when a string was
+            // refused rather than malformed.
+
+            TValue Finish(bool Strict = false)
             {
-                StartIndex = Index;
-                while (Index < sv.length() && sv[Index] != ',' && sv[Index] != Stop)
-                {
-                    // if (sv[Index] != ' ')
-                    //     EndIndex = Index;
+                if (Strict && Refused)
+                    Escape::Refuse();
 
-                    Index++;
-                }
+                while (!Frames.empty())
+                    Close();
 
-                EndIndex = Index;
+                return std::move(Result);
+            }
 
-                if (Index > sv.length())
-                    return "";
+        private:
+            struct Frame
+            {
+                TValue Container;
+                std::optional<typename T::Key> Key;
+            };
 
-                Index++;
+            std::pmr::memory_resource *Resource;
+            std::pmr::vector<Frame> Frames;
+            std::optional<typename T::Key> PendingKey;
+            TValue Result;
+            bool Refused = false;
 
-                auto Value = sv.substr(StartIndex, EndIndex - StartIndex);
+            // Strategies declaring Boxes keep some of their values out of line on Resource
 
-                if (Value == "null")
-                {
-                    return typename FirstWhere<is_null, TO...>::type{nullptr};
-                }
-                else if (Value == "true")
-                {
-                    return typename FirstWhere<is_bool, TO...>::type{true};
-                }
-                else if (Value == "false")
-                {
-                    return typename FirstWhere<is_bool, TO...>::type{false};
-                }
-                else if (auto IntegerValue = IsNumber<std::int64_t>(Value))
-                {
-                    return IntegerValue.value();
-                }
-                else if (auto DoubleValue = IsNumber<double>(Value))
-                {
-                    return DoubleValue.value();
-                }
+            template <typename TItem>
+            TValue Make(TItem &&Item)
+            {
+                if constexpr (requires { TValue::Boxes; })
+                    return TValue(std::forward<TItem>(Item), Resource);
                 else
-                {
-                    return Value;
-                }
+                    return TValue(std::forward<TItem>(Item));
+            }
+
+            void Add(TValue &&Value, std::optional<typename T::Key> &Key)
+            {
+                if (Frames.empty())
+                    Result = std::move(Value);
+                else if (auto &Parent = Frames.back().Container; Parent.template Is<T>())
+                    Parent.template As<T>().GetMap().emplace(std::move(Key.value()), std::move(Value));
+                else
+                    Parent.template As<typename T::Array>().push_back(std::move(Value));
+
+                Key.reset();
             }
+
+            void Close()
+            {
+                auto Top = std::move(Frames.back());
+
+                Frames.pop_back();
+
+                Add(std::move(Top.Container), Top.Key);
+            }
+        };
+
+        using Builder = Building<DefaultStrategy>;
+
+        // Parses the value the cursor points at by feeding the Sax parser into a Builder
+
+        static DefaultStrategy From(Structural::Cursor &Cursor, std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
+        {
+            return Builder::Parse(Cursor, Resource);
+        }
+
+        // Same, counting the nodes and string copies into Stats, see Statistics
+
+        static DefaultStrategy From(Structural::Cursor &Cursor, Statistics &Stats, std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
+        {
+            return Builder::Parse(Cursor, Stats, Resource);
+        }
+
+        // Same, reporting what went wrong and where in Failure
+
+        static DefaultStrategy From(Structural::Cursor &Cursor, Status &Failure, std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
+        {
+            return Builder::Parse(Cursor, Failure, Resource);
+        }
+
+        // Parses the whole of sv, which has to hold exactly one value, without throwing
+
+        static Result<DefaultStrategy> TryFrom(std::string_view sv, std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
+        {
+            return Builder::TryParse(sv, Resource);
         }
 
         template <typename... Types>
@@ -610,8 +871,10 @@ namespace Core
             }
         }
 
-        template <typename TSerializer>
-        friend TSerializer &operator<<(TSerializer &os, DefaultStrategy const &value)
+        // Writes a value of any strategy holding these types, their operator<< all go through it
+
+        template <typename TSerializer, typename TValue>
+        static TSerializer &Write(TSerializer &os, TValue const &value)
         {
             return value.Visit(
                 [&](auto &&arg) mutable -> TSerializer &
@@ -620,18 +883,21 @@ namespace Core
 
                     if constexpr (std::is_same_v<TArg, typename T::Array>)
                     {
-                        size_t i = 0;
-
                         os << '[';
 
-                        for (; i < arg.size() - 1; i++)
-                            os << arg[i] << ", ";
+                        for (size_t i = 0; i < arg.size(); i++)
+                            os << (i ? ", " : "") << arg[i];
 
-                        return os << arg[i] << ']';
+                        return os << ']';
                     }
                     else if constexpr (is_string<TArg>::value)
                     {
-                        return os << '\"' << arg << '\"';
+                        os << '"';
+
+                        Escape::Encode(std::string_view(arg), [&](std::string_view Piece)
+                                       { os << Piece; });
+
+                        return os << '"';
                     }
                     else if constexpr (is_bool<TArg>::value)
                     {
@@ -647,5 +913,354 @@ namespace Core
                     }
                 });
         }
+
+        template <typename TSerializer>
+        friend TSerializer &operator<<(TSerializer &os, DefaultStrategy const &value)
+        {
+            return Write(os, value);
+        }
+    };
+
+    // Parses containers one level at a time. A nested object or array is only skipped over
+    // and kept as the raw text of its subtree, it gets parsed the first time it is accessed
+    // through operator[], Is, As, Visit, GetVariant or Index and the result replaces the text.
+    // The input and Resource have to outlive the value until then. Materialising modifies
+    // the value even through const access, so a value must not be first accessed from
+    // several threads at once.
+
+    template <typename T, typename... TO>
+    struct LazyStrategy : public DefaultStrategy<T, TO...>
+    {
+    public:
+        using Base = DefaultStrategy<T, TO...>;
+
+        using Base::Base;
+
+        constexpr LazyStrategy() = default;
+
+        // Parses the value the cursor points at, members that are containers are deferred
+
+        static LazyStrategy From(Structural::Cursor &Cursor, std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
+        {
+            LazyStrategy Result;
+
+            if (char Token = Cursor.Peek(); Token == '{')
+            {
+                auto Object = Allocate<T>(Resource);
+
+                Cursor.Next();
+
+                while (Cursor.Peek() == '"')
+                {
+                    auto Raw = Cursor.String();
+                    auto Escaped = Escape::Classify(Raw, Cursor);
+                    auto Key = Escape::Make<typename T::Key>(Raw, Escaped, Resource);
+
+                    if (!Key)
+                        Escape::Require<typename T::Key>(Raw, Escaped == Escape::Kind::Escaped, Resource);
+
+                    if (!Key || Cursor.Peek() != ':')
+                        break;
+
+                    Cursor.Next();
+
+                    Object.GetMap().emplace(std::move(*Key), Member(Cursor, Resource));
+
+                    if (Cursor.Peek() != ',')
+                        break;
+
+                    Cursor.Next();
+                }
+
+                if (Cursor.Peek() == '}')
+                    Cursor.Next();
+
+                Result = std::move(Object);
+            }
+            else if (Token == '[')
+            {
+                auto Items = Allocate<typename T::Array>(Resource);
+
+                Cursor.Next();
+
+                while (Cursor.Peek() != ']' && !Cursor.End())
+                {
+                    Items.push_back(Member(Cursor, Resource));
+
+                    if (Cursor.Peek() != ',')
+                        break;
+
+                    Cursor.Next();
+                }
+
+                if (Cursor.Peek() == ']')
+                    Cursor.Next();
+
+                Result = std::move(Items);
+            }
+            else if (Token == '"')
+            {
+                using Text = typename FirstWhere<Base::template is_string, TO...>::type;
+
+                auto Raw = Cursor.String();
+                auto Escaped = Escape::Classify(Raw, Cursor);
+
+                if (auto Value = Escape::Make<Text>(Raw, Escaped, Resource))
+                    Result = std::move(*Value);
+                else
+                    Escape::Require<Text>(Raw, Escaped == Escape::Kind::Escaped, Resource);
+            }
+            else if (!Cursor.End() && !Structural::IsOperator(Token))
+            {
+                Scalar Handler{Result};
+
+                Sax::Scalar(Cursor.Scalar(), Handler);
+            }
+
+            return Result;
+        }
+
+        // Whether the value has been parsed, or was never deferred
+
+        constexpr bool Parsed() const
+        {
+            return Raw.empty();
+        }
+
+        constexpr std::string_view GetRaw() const
+        {
+            return Raw;
+        }
+
+        template <typename Target>
+        constexpr inline bool Is() const
+        {
+            Materialise();
+
+            return Base::template Is<Target>();
+        }
+
+        template <template <typename> typename TCondition>
+        constexpr inline bool Is() const
+        {
+            Materialise();
+
+            return Base::template Is<TCondition>();
+        }
+
+        template <typename Target>
+        constexpr inline decltype(auto) As()
+        {
+            Materialise();
+
+            return Base::template As<Target>();
+        }
+
+        template <typename Target>
+        constexpr inline decltype(auto) As() const
+        {
+            Materialise();
+
+            return Base::template As<Target>();
+        }
+
+        constexpr LazyStrategy &operator[](typename T::Key const &Key)
+        {
+            Materialise();
+
+            // Every element of the storages is a LazyStrategy, Recursive only knows it as itself
+
+            return static_cast<LazyStrategy &>(Base::operator[](Key));
+        }
+
+        constexpr LazyStrategy &operator[](std::size_t Index)
+        {
+            Materialise();
+
+            return static_cast<LazyStrategy &>(Base::operator[](Index));
+        }
+
+        constexpr decltype(auto) Visit(auto &&Visitor)
+        {
+            Materialise();
+
+            return Base::Visit(std::forward<decltype(Visitor)>(Visitor));
+        }
+
+        constexpr decltype(auto) Visit(auto &&Visitor) const
+        {
+            Materialise();
+
+            return Base::Visit(std::forward<decltype(Visitor)>(Visitor));
+        }
+
+        constexpr auto &GetVariant()
+        {
+            Materialise();
+
+            return Base::GetVariant();
+        }
+
+        constexpr auto &GetVariant() const
+        {
+            Materialise();
+
+            return Base::GetVariant();
+        }
+
+        constexpr inline auto Index() const
+        {
+            Materialise();
+
+            return Base::Index();
+        }
+
+        constexpr LazyStrategy *Find(typename T::Key const &Key)
+        {
+            Materialise();
+
+            return static_cast<LazyStrategy *>(Base::Find(Key));
+        }
+
+        constexpr LazyStrategy const *Find(typename T::Key const &Key) const
+        {
+            Materialise();
+
+            return static_cast<LazyStrategy const *>(Base::Find(Key));
+        }
+
+        constexpr LazyStrategy *Find(std::size_t Index)
+        {
+            Materialise();
+
+            return static_cast<LazyStrategy *>(Base::Find(Index));
+        }
+
+        constexpr LazyStrategy const *Find(std::size_t Index) const
+        {
+            Materialise();
+
+            return static_cast<LazyStrategy const *>(Base::Find(Index));
+        }
+
+        template <typename Target>
+        constexpr Target *TryAs()
+        {
+            Materialise();
+
+            return Base::template TryAs<Target>();
+        }
+
+        template <typename Target>
+        constexpr Target const *TryAs() const
+        {
+            Materialise();
+
+            return Base::template TryAs<Target>();
+        }
+
+        template <typename Target>
+        constexpr std::optional<Target> TryGet(typename T::Key const &Key) const
+        {
+            if (auto Member = Find(Key))
+            {
+                if (auto Value = Member->template TryAs<Target>())
+                    return *Value;
+            }
+
+            return std::nullopt;
+        }
+
+        template <typename Types>
+        constexpr bool operator==(Types &&Other) const
+        {
+            Materialise();
+
+            if constexpr (std::is_same_v<std::decay_t<Types>, LazyStrategy>)
+            {
+                Other.Materialise();
+
+                return Base::operator==(static_cast<Base const &>(Other));
+            }
+            else
+            {
+                return Base::operator==(std::forward<Types>(Other));
+            }
+        }
+
+        template <typename TSerializer>
+        friend TSerializer &operator<<(TSerializer &os, LazyStrategy const &value)
+        {
+            value.Materialise();
+
+            return os << static_cast<Base const &>(value);
+        }
+
+    private:
+        std::string_view Raw;
+        std::pmr::memory_resource *Resource = nullptr;
+
+        // Sets the value from the literal or number reported by Sax::Scalar
+
+        struct Scalar
+        {
+            LazyStrategy &Target;
+
+            void Integer(std::int64_t Value)
+            {
+                Target = LazyStrategy(Value);
+            }
+
+            void Double(double Value)
+            {
+                Target = LazyStrategy(Value);
+            }
+
+            void Number(Core::Number Value)
+                requires(Contains<Core::Number, TO...>::value)
+            {
+                Target = LazyStrategy(Value);
+            }
+
+            void Boolean(bool Value)
+            {
+                Target = LazyStrategy(typename FirstWhere<Base::template is_bool, TO...>::type{Value});
+            }
+
+            void Null()
+            {
+                Target = LazyStrategy(typename FirstWhere<Base::template is_null, TO...>::type{nullptr});
+            }
+        };
+
+        // Containers are skipped and kept as text, everything else is parsed right away
+
+        static LazyStrategy Member(Structural::Cursor &Cursor, std::pmr::memory_resource *Resource)
+        {
+            if (char Token = Cursor.Peek(); Token != '{' && Token != '[')
+                return From(Cursor, Resource);
+
+            LazyStrategy Result;
+
+            Result.Raw = Cursor.Raw();
+            Result.Resource = Resource;
+
+            return Result;
+        }
+
+        // Indexes and parses the deferred text, leaving the nested containers deferred in turn
+
+        constexpr void Materialise() const
+        {
+            if (Raw.empty())
+                return;
+
+            Structural::Index Positions{Raw};
+            Structural::Cursor Cursor{Positions};
+
+            auto &Self = const_cast<LazyStrategy &>(*this);
+
+            Self = From(Cursor, Resource);
+        }
     };
 }
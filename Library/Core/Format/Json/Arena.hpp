@@ -0,0 +1,263 @@
+#pragma once
+
+#include <new>
+#include <algorithm>
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include <variant>
+#include <string_view>
+#include <type_traits>
+#include <memory_resource>
+
+namespace Core
+{
+    // Bump allocator handing out memory from a list of growing chunks. Deallocation is a
+    // no-op and everything is given back to the upstream resource at once on Release.
+
+    class Arena : public std::pmr::memory_resource
+    {
+    public:
+        explicit Arena(std::size_t InitialSize = 4096, std::pmr::memory_resource *Upstream = std::pmr::new_delete_resource())
+            : NextSize(InitialSize), Upstream(Upstream)
+        {
+        }
+
+        Arena(Arena const &) = delete;
+        Arena &operator=(Arena const &) = delete;
+
+        ~Arena()
+        {
+            Release();
+        }
+
+        void Release()
+        {
+            while (Head)
+            {
+                Chunk *Previous = Head->Previous;
+
+                Upstream->deallocate(Head, Head->Size, alignof(Chunk));
+
+                Head = Previous;
+            }
+
+            Current = Limit = nullptr;
+        }
+
+        // Number of allocations served and bytes requested since construction
+
+        std::size_t Allocations() const
+        {
+            return AllocationCount;
+        }
+
+        std::size_t BytesAllocated() const
+        {
+            return ByteCount;
+        }
+
+        // Number of chunks requested from the upstream resource
+
+        std::size_t Chunks() const
+        {
+            return ChunkCount;
+        }
+
+    protected:
+        void *do_allocate(std::size_t Bytes, std::size_t Alignment) override
+        {
+            void *Pointer = Current;
+            std::size_t Space = Limit - Current;
+
+            if (!std::align(Alignment, Bytes, Pointer, Space))
+            {
+                Grow(Bytes + Alignment);
+
+                Pointer = Current;
+                Space = Limit - Current;
+
+                std::align(Alignment, Bytes, Pointer, Space);
+            }
+
+            Current = static_cast<char *>(Pointer) + Bytes;
+
+            ++AllocationCount;
+            ByteCount += Bytes;
+
+            return Pointer;
+        }
+
+        void do_deallocate(void *, std::size_t, std::size_t) override
+        {
+        }
+
+        bool do_is_equal(std::pmr::memory_resource const &Other) const noexcept override
+        {
+            return this == &Other;
+        }
+
+    private:
+        struct Chunk
+        {
+            Chunk *Previous;
+            std::size_t Size;
+        };
+
+        Chunk *Head = nullptr;
+        char *Current = nullptr;
+        char *Limit = nullptr;
+
+        std::size_t NextSize;
+        std::pmr::memory_resource *Upstream;
+
+        std::size_t AllocationCount = 0;
+        std::size_t ByteCount = 0;
+        std::size_t ChunkCount = 0;
+
+        void Grow(std::size_t Minimum)
+        {
+            std::size_t Size = std::max(NextSize, Minimum + sizeof(Chunk));
+
+            Head = new (Upstream->allocate(Size, alignof(Chunk))) Chunk{Head, Size};
+
+            Current = reinterpret_cast<char *>(Head + 1);
+            Limit = reinterpret_cast<char *>(Head) + Size;
+
+            NextSize = Size * 2;
+            ++ChunkCount;
+        }
+    };
+
+    // Forwards to another resource while counting what goes through it
+
+    class CountingResource : public std::pmr::memory_resource
+    {
+    public:
+        explicit CountingResource(std::pmr::memory_resource *Upstream = std::pmr::get_default_resource())
+            : Upstream(Upstream)
+        {
+        }
+
+        std::size_t Allocations() const
+        {
+            return AllocationCount;
+        }
+
+        std::size_t Deallocations() const
+        {
+            return DeallocationCount;
+        }
+
+        std::size_t BytesAllocated() const
+        {
+            return ByteCount;
+        }
+
+    protected:
+        void *do_allocate(std::size_t Bytes, std::size_t Alignment) override
+        {
+            ++AllocationCount;
+            ByteCount += Bytes;
+
+            return Upstream->allocate(Bytes, Alignment);
+        }
+
+        void do_deallocate(void *Pointer, std::size_t Bytes, std::size_t Alignment) override
+        {
+            ++DeallocationCount;
+
+            Upstream->deallocate(Pointer, Bytes, Alignment);
+        }
+
+        bool do_is_equal(std::pmr::memory_resource const &Other) const noexcept override
+        {
+            return this == &Other;
+        }
+
+    private:
+        std::pmr::memory_resource *Upstream;
+
+        std::size_t AllocationCount = 0;
+        std::size_t DeallocationCount = 0;
+        std::size_t ByteCount = 0;
+    };
+
+    // Whether a value can be left undestroyed in an arena, as it either owns nothing or
+    // allocates from the resource it is given
+
+    template <typename TItem>
+    constexpr bool Abandonable = std::is_trivially_destructible_v<TItem> || std::uses_allocator_v<TItem, std::pmr::polymorphic_allocator<std::byte>>;
+
+    template <typename TJson, typename TVariant>
+    struct AbandonableItems;
+
+    template <typename TJson, typename... TItems>
+    struct AbandonableItems<TJson, std::variant<TItems...>>
+    {
+        constexpr static bool value = ((std::is_same_v<TItems, TJson> || std::is_same_v<TItems, typename TJson::Array> || Abandonable<TItems>) && ...);
+    };
+
+    // Owns a document parsed into its own arena. The tree is placed in the arena and never
+    // destroyed, dropping the document gives the chunks back in one go instead of walking
+    // every node. This is only sound as long as every container and string of the tree
+    // allocates from the arena, i.e. the Json is instantiated with the std::pmr containers,
+    // which is checked at compile time.
+
+    template <typename TJson>
+    class Document
+    {
+        // The types a value holds, strategies reusing DefaultStrategy declare it as Traits
+
+        constexpr static auto Items()
+        {
+            if constexpr (requires { typename TJson::Value::Traits; })
+                return std::type_identity<typename TJson::Value::Traits::Value>{};
+            else
+                return std::type_identity<typename TJson::Value::Value>{};
+        }
+
+        static_assert(Abandonable<typename TJson::Map> && Abandonable<typename TJson::Array> && Abandonable<typename TJson::Key> &&
+                          AbandonableItems<TJson, typename decltype(Items())::type>::value,
+                      "A Document never destroys its tree, use the std::pmr containers and strings");
+
+    public:
+        explicit Document(std::string_view sv, std::size_t InitialSize = 0)
+            : Memory(InitialSize ? InitialSize : sv.size() * 4 + 256),
+              Root(new (Memory.allocate(sizeof(TJson), alignof(TJson))) TJson(TJson::From(sv, &Memory)))
+        {
+        }
+
+        Document(Document const &) = delete;
+        Document &operator=(Document const &) = delete;
+
+        TJson &operator*()
+        {
+            return *Root;
+        }
+
+        TJson const &operator*() const
+        {
+            return *Root;
+        }
+
+        TJson *operator->()
+        {
+            return Root;
+        }
+
+        TJson const *operator->() const
+        {
+            return Root;
+        }
+
+        Arena &GetArena()
+        {
+            return Memory;
+        }
+
+    private:
+        Arena Memory;
+        TJson *Root;
+    };
+}
@@ -0,0 +1,298 @@
+#pragma once
+
+#include <bit>
+#include <array>
+#include <tuple>
+#include <string>
+#include <cstdint>
+#include <utility>
+#include <string_view>
+#include <type_traits>
+
+#include "Sax.hpp"
+#include "Escape.hpp"
+#include "Describe.hpp"
+#include "Structural.hpp"
+
+// Parses straight into described types (see Describe.hpp) without building a tree. Members
+// are matched through a perfect hash of the field names found while compiling, which leaves
+// one hash and one comparison per key. Members can be other described types, booleans,
+// numbers, strings, std::optional (null resets it) and containers with emplace_back.
+// Unknown keys are skipped and members absent from the input keep their value. Escapes are
+// decoded into owning strings, std::string_view members have nowhere to keep decoded text so
+// strings with escapes fail to bind to them.
+
+namespace Core::Bind
+{
+    constexpr std::uint64_t Hash(std::string_view Key, std::uint64_t Seed)
+    {
+        std::uint64_t Result = 0xcbf29ce484222325ULL ^ (Seed * 0x9e3779b97f4a7c15ULL);
+
+        for (char c : Key)
+            Result = (Result ^ static_cast<unsigned char>(c)) * 0x100000001b3ULL;
+
+        return Result ^ (Result >> 29);
+    }
+
+    template <typename T>
+    bool Read(Structural::Cursor &Cursor, T &Out);
+
+    // Slot of every field name, the seed being searched for until no two names collide
+
+    template <typename T>
+    class Table
+    {
+    public:
+        using Reader = bool (*)(Structural::Cursor &, T &);
+
+        // Reader of the member named Key, nullptr for unknown keys
+
+        constexpr static Reader Find(std::string_view Key)
+        {
+            auto &Entry = Slots[Hash(Key, Seed) & (Size - 1)];
+
+            return Entry.Name == Key ? Entry.Read : nullptr;
+        }
+
+    private:
+        struct Slot
+        {
+            std::string_view Name;
+            Reader Read = nullptr;
+        };
+
+        constexpr static auto &Fields = Describe<T>::Fields;
+        constexpr static std::size_t Count = std::tuple_size_v<std::decay_t<decltype(Fields)>>;
+        constexpr static std::size_t Size = std::bit_ceil(Count * 2);
+
+        consteval static std::uint64_t Search()
+        {
+            auto Names = std::apply([](auto const &...Field)
+                                    { return std::array<std::string_view, Count>{Field.Name...}; },
+                                    Fields);
+
+            for (std::uint64_t Seed = 0;; ++Seed)
+            {
+                std::array<bool, Size> Used{};
+
+                bool Collision = false;
+
+                for (auto Name : Names)
+                {
+                    auto &Taken = Used[Hash(Name, Seed) & (Size - 1)];
+
+                    Collision |= Taken;
+                    Taken = true;
+                }
+
+                if (!Collision)
+                    return Seed;
+            }
+        }
+
+        template <std::size_t... Indices>
+        consteval static std::array<Slot, Size> Build(std::index_sequence<Indices...>)
+        {
+            std::array<Slot, Size> Result{};
+
+            ((Result[Hash(std::get<Indices>(Fields).Name, Seed) & (Size - 1)] =
+                  Slot{std::get<Indices>(Fields).Name, [](Structural::Cursor &Cursor, T &Out)
+                       { return Read(Cursor, Out.*(std::get<Indices>(Fields).Member)); }}),
+             ...);
+
+            return Result;
+        }
+
+        constexpr static std::uint64_t Seed = Search();
+        constexpr static std::array<Slot, Size> Slots = Build(std::make_index_sequence<Count>{});
+    };
+
+    template <typename T>
+    bool Object(Structural::Cursor &Cursor, T &Out)
+    {
+        if (Cursor.Peek() != '{')
+            return false;
+
+        Cursor.Next();
+
+        if (Cursor.Peek() == '}')
+        {
+            Cursor.Next();
+            return true;
+        }
+
+        while (Cursor.Peek() == '"')
+        {
+            auto Key = Cursor.String();
+            auto Type = Escape::Classify(Key, Cursor);
+
+            if (Type == Escape::Kind::Invalid || Cursor.Peek() != ':')
+                return false;
+
+            Cursor.Next();
+
+            std::string Decoded;
+
+            if (Type == Escape::Kind::Escaped)
+            {
+                Decoded.resize(Key.size());
+
+                auto Size = Escape::Decode(Key, Decoded.data());
+
+                if (Size == Escape::Invalid)
+                    return false;
+
+                Key = std::string_view{Decoded.data(), Size};
+            }
+
+            if (auto Member = Table<T>::Find(Key))
+            {
+                if (!Member(Cursor, Out))
+                    return false;
+            }
+            else
+            {
+                Cursor.Raw();
+            }
+
+            if (Cursor.Peek() == '}')
+            {
+                Cursor.Next();
+                return true;
+            }
+
+            if (Cursor.Peek() != ',')
+                return false;
+
+            Cursor.Next();
+        }
+
+        return false;
+    }
+
+    // Reads the value the cursor points at into Out, false when it doesn't fit its type
+
+    template <typename T>
+    bool Read(Structural::Cursor &Cursor, T &Out)
+    {
+        if constexpr (Described<T>)
+        {
+            return Object(Cursor, Out);
+        }
+        else if constexpr (requires { Out.reset(); Out.emplace(); *Out; })
+        {
+            if (Cursor.Peek() == 'n' && Cursor.Scalar() == "null")
+            {
+                Out.reset();
+                return true;
+            }
+
+            return Read(Cursor, Out.emplace());
+        }
+        else if constexpr (std::is_same_v<T, bool>)
+        {
+            if (Cursor.Peek() == '"' || Structural::IsOperator(Cursor.Peek()))
+                return false;
+
+            auto Token = Cursor.Scalar();
+
+            Out = Token == "true";
+
+            return Out || Token == "false";
+        }
+        else if constexpr (std::is_arithmetic_v<T>)
+        {
+            if (Cursor.Peek() == '"' || Structural::IsOperator(Cursor.Peek()))
+                return false;
+
+            // Checked against the grammar first, std::from_chars taking nan, inf and leading
+            // zeros as well
+
+            auto Token = Cursor.Scalar();
+
+            std::int64_t Integer;
+            double Double;
+
+            auto Type = Core::Number::Scan(Token, Integer, &Double);
+
+            if constexpr (std::is_floating_point_v<T>)
+            {
+                if (Type == Core::Number::Kind::Invalid || Type == Core::Number::Kind::OutOfRange)
+                    return false;
+
+                if (Sax::Number(Token, Out))
+                    return true;
+
+                // Too small rather than too large for T, rounds to zero as in Number::As
+
+                if (Double <= -1 || Double >= 1)
+                    return false;
+
+                Out = static_cast<T>(Double);
+
+                return true;
+            }
+            else
+            {
+                return (Type == Core::Number::Kind::Integer || Type == Core::Number::Kind::Big) && Sax::Number(Token, Out);
+            }
+        }
+        else if constexpr (std::is_assignable_v<T &, std::string_view>)
+        {
+            if (Cursor.Peek() != '"')
+                return false;
+
+            auto Raw = Cursor.String();
+            auto Value = Escape::Make<T>(Raw, Escape::Classify(Raw, Cursor), std::pmr::new_delete_resource());
+
+            if (Value)
+                Out = std::move(*Value);
+
+            return Value.has_value();
+        }
+        else
+        {
+            static_assert(requires { Out.emplace_back(); Out.clear(); }, "Type can not be bound");
+
+            if (Cursor.Peek() != '[')
+                return false;
+
+            Cursor.Next();
+            Out.clear();
+
+            if (Cursor.Peek() == ']')
+            {
+                Cursor.Next();
+                return true;
+            }
+
+            while (Read(Cursor, Out.emplace_back()))
+            {
+                if (Cursor.Peek() == ']')
+                {
+                    Cursor.Next();
+                    return true;
+                }
+
+                if (Cursor.Peek() != ',')
+                    return false;
+
+                Cursor.Next();
+            }
+
+            return false;
+        }
+    }
+
+    // Parses a whole document into Out, false on malformed input or values not fitting their
+    // members, Out being left partially filled in that case
+
+    template <typename T>
+    bool Parse(std::string_view sv, T &Out)
+    {
+        Structural::Index Positions{sv};
+        Structural::Cursor Cursor{Positions};
+
+        return Read(Cursor, Out) && Cursor.End();
+    }
+}
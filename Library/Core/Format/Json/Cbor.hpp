@@ -0,0 +1,567 @@
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <memory_resource>
+
+#include "Sax.hpp"
+#include "Escape.hpp"
+#include "Number.hpp"
+#include "Describe.hpp"
+
+// CBOR (RFC 8949) in both directions, for services exchanging documents without going
+// through text. Integers, floats and strings are written as their binary types so neither
+// side formats or parses numbers, and strings are copied as they are instead of escaped.
+//
+// Encoding walks values through their members like Writer does and works on the same
+// values : the strategies, Tape views, described types and the std containers. Containers
+// are written with definite lengths and floats take 4 bytes whenever that loses nothing.
+//
+// Decoding reports the items to a Sax handler, so the Builder of any strategy builds the
+// tree out of them. Text strings are views into the input, so strategies storing
+// std::string_view decode without copying, and are checked to be valid UTF-8. Maps must have
+// text keys. Byte strings and indefinite length strings have no Json equivalent and are
+// errors, tags are skipped and undefined reads as null.
+
+namespace Core::Cbor
+{
+    enum class Major : std::uint8_t
+    {
+        Unsigned = 0,
+        Negative = 1,
+        Bytes = 2,
+        Text = 3,
+        Array = 4,
+        Map = 5,
+        Tag = 6,
+        Simple = 7
+    };
+
+    template <typename TSink>
+    class Encoder
+    {
+    public:
+        explicit Encoder(TSink &Sink)
+            : Sink(Sink)
+        {
+        }
+
+        Encoder(Encoder const &) = delete;
+        Encoder &operator=(Encoder const &) = delete;
+
+        ~Encoder()
+        {
+            Flush();
+        }
+
+        template <typename TValue>
+        Encoder &Write(TValue const &Value)
+        {
+            if constexpr (Described<TValue>)
+            {
+                std::size_t Count = 0;
+
+                Members(Value, [&](std::string_view, auto const &)
+                        { ++Count; });
+
+                Head(Major::Map, Count);
+
+                Members(Value, [&](std::string_view Name, auto const &Member)
+                        {
+                            String(Name);
+                            Write(Member); });
+            }
+            else if constexpr (requires { Value.has_value(); *Value; })
+            {
+                if (Value.has_value())
+                    Write(*Value);
+                else
+                    Put(char(0xF6));
+            }
+            else if constexpr (requires { Value.GetMap(); })
+            {
+                Object(Value.GetMap());
+            }
+            else if constexpr (requires { Value.Visit([](auto const &) {}); })
+            {
+                Value.Visit([&](auto const &Item)
+                            { Write(Item); });
+            }
+            else if constexpr (std::is_same_v<TValue, Core::Number>)
+            {
+                std::int64_t Integer;
+
+                if (Core::Number::Scan(Value.GetRaw(), Integer) == Core::Number::Kind::Integer)
+                    Write(Integer);
+                else
+                    Write(Value.template As<double>());
+            }
+            else if constexpr (std::is_same_v<TValue, bool>)
+            {
+                Put(char(Value ? 0xF5 : 0xF4));
+            }
+            else if constexpr (std::is_same_v<TValue, std::nullptr_t>)
+            {
+                Put(char(0xF6));
+            }
+            else if constexpr (std::is_integral_v<TValue>)
+            {
+                // Negative integers hold -1 - n, which is the complement of n
+
+                if (Value < 0)
+                    Head(Major::Negative, ~static_cast<std::uint64_t>(static_cast<std::int64_t>(Value)));
+                else
+                    Head(Major::Unsigned, static_cast<std::uint64_t>(Value));
+            }
+            else if constexpr (std::is_floating_point_v<TValue>)
+            {
+                // Doubles beyond the range of a float can't be narrowed, the conversion being
+                // undefined, so only the others are tried as one
+
+                double Double = Value;
+                bool Fits = !std::isfinite(Double) || std::fabs(Double) <= std::numeric_limits<float>::max();
+                float Single = Fits ? static_cast<float>(Double) : 0;
+
+                if (Fits && (Single == Double || std::isnan(Double)))
+                {
+                    Put(char(0xFA));
+                    BigEndian(std::bit_cast<std::uint32_t>(Single), 4);
+                }
+                else
+                {
+                    Put(char(0xFB));
+                    BigEndian(std::bit_cast<std::uint64_t>(Double), 8);
+                }
+            }
+            else if constexpr (std::is_constructible_v<std::string_view, TValue const &>)
+            {
+                String(Value);
+            }
+            else if constexpr (requires { (*std::begin(Value)).first; (*std::begin(Value)).second; })
+            {
+                Object(Value);
+            }
+            else
+            {
+                static_assert(requires { std::begin(Value); std::end(Value); }, "Value can not be encoded");
+
+                Head(Major::Array, Count(Value));
+
+                for (auto const &Item : Value)
+                    Write(Item);
+            }
+
+            return *this;
+        }
+
+        // Hands whatever is staged over to the sink
+
+        void Flush()
+        {
+            if (Used)
+            {
+                Emit({Staging, Used});
+                Used = 0;
+            }
+        }
+
+    private:
+        constexpr static std::size_t Capacity = 4096;
+
+        TSink &Sink;
+
+        std::size_t Used = 0;
+        char Staging[Capacity];
+
+        void Emit(std::string_view Piece)
+        {
+            if constexpr (requires { Sink.append(Piece.data(), Piece.size()); })
+                Sink.append(Piece.data(), Piece.size());
+            else
+                Sink(Piece);
+        }
+
+        void Put(char c)
+        {
+            if (Used == Capacity)
+                Flush();
+
+            Staging[Used++] = c;
+        }
+
+        void Put(std::string_view Piece)
+        {
+            if (Piece.size() > Capacity - Used)
+            {
+                Flush();
+
+                if (Piece.size() > Capacity)
+                    return Emit(Piece);
+            }
+
+            std::memcpy(Staging + Used, Piece.data(), Piece.size());
+            Used += Piece.size();
+        }
+
+        void BigEndian(std::uint64_t Value, std::size_t Size)
+        {
+            if (Size > Capacity - Used)
+                Flush();
+
+            for (std::size_t i = Size; i--;)
+                Staging[Used++] = static_cast<char>(Value >> (8 * i));
+        }
+
+        // Initial byte of an item followed by its argument in as few bytes as it fits
+
+        void Head(Major Type, std::uint64_t Argument)
+        {
+            char Initial = static_cast<char>(static_cast<std::uint8_t>(Type) << 5);
+
+            if (Argument < 24)
+            {
+                Put(static_cast<char>(Initial | Argument));
+            }
+            else if (Argument <= UINT8_MAX)
+            {
+                Put(static_cast<char>(Initial | 24));
+                BigEndian(Argument, 1);
+            }
+            else if (Argument <= UINT16_MAX)
+            {
+                Put(static_cast<char>(Initial | 25));
+                BigEndian(Argument, 2);
+            }
+            else if (Argument <= UINT32_MAX)
+            {
+                Put(static_cast<char>(Initial | 26));
+                BigEndian(Argument, 4);
+            }
+            else
+            {
+                Put(static_cast<char>(Initial | 27));
+                BigEndian(Argument, 8);
+            }
+        }
+
+        void String(std::string_view Value)
+        {
+            Head(Major::Text, Value.size());
+            Put(Value);
+        }
+
+        template <typename TItems>
+        static std::size_t Count(TItems const &Items)
+        {
+            if constexpr (requires { std::size(Items); })
+            {
+                return std::size(Items);
+            }
+            else if constexpr (requires { Items.Size(); })
+            {
+                return Items.Size();
+            }
+            else
+            {
+                std::size_t Result = 0;
+
+                for (auto i = std::begin(Items), End = std::end(Items); i != End; ++i)
+                    ++Result;
+
+                return Result;
+            }
+        }
+
+        template <typename TMap>
+        void Object(TMap const &Members)
+        {
+            Head(Major::Map, Count(Members));
+
+            for (auto const &Member : Members)
+            {
+                String(Member.first);
+                Write(Member.second);
+            }
+        }
+    };
+
+    // Encodes Value into a sink, see Writer for what a sink can be
+
+    template <typename TValue, typename TSink>
+    void Encode(TValue const &Value, TSink &&Sink)
+    {
+        Encoder<std::remove_reference_t<TSink>>{Sink}.Write(Value);
+    }
+
+    template <typename TValue>
+    std::string Encode(TValue const &Value)
+    {
+        std::string Result;
+
+        Encode(Value, Result);
+
+        return Result;
+    }
+
+    inline double Half(std::uint16_t Bits)
+    {
+        int Exponent = (Bits >> 10) & 0x1F;
+        double Mantissa = Bits & 0x3FF;
+        double Value;
+
+        if (Exponent == 0)
+            Value = std::ldexp(Mantissa, -24);
+        else if (Exponent != 31)
+            Value = std::ldexp(Mantissa + 1024, Exponent - 25);
+        else
+            Value = Mantissa == 0 ? INFINITY : NAN;
+
+        return Bits & 0x8000 ? -Value : Value;
+    }
+
+    // Reports the single item at the start of Bytes to Handler, see Sax for the handler
+    // members. Returns false on malformed input or when the handler asked to stop, Offset is
+    // left right after the item.
+
+    template <typename THandler>
+    bool Parse(std::string_view Bytes, THandler &Handler, std::size_t &Offset)
+    {
+        constexpr std::uint64_t Indefinite = UINT64_MAX;
+
+        // Items left in each open container and, for maps, whether a value comes next
+
+        struct Level
+        {
+            std::uint64_t Remaining;
+            bool Object;
+            bool Value;
+        };
+
+        Level Levels[Sax::MaxDepth];
+        std::size_t Depth = 0;
+        std::string Scratch;
+
+        auto Read = [&](std::size_t Size, std::uint64_t &Value)
+        {
+            if (Size > Bytes.size() - Offset)
+                return false;
+
+            Value = 0;
+
+            for (std::size_t i = 0; i < Size; ++i)
+                Value = Value << 8 | static_cast<unsigned char>(Bytes[Offset++]);
+
+            return true;
+        };
+
+        auto Close = [&]
+        {
+            bool Object = Levels[--Depth].Object;
+
+            return Object ? Sax::Emit([&]
+                                      { return Handler.EndObject(); })
+                          : Sax::Emit([&]
+                                      { return Handler.EndArray(); });
+        };
+
+        // Closes the definite containers whose last item was just read
+
+        auto Unwind = [&]
+        {
+            while (Depth && !Levels[Depth - 1].Remaining)
+            {
+                if (!Close())
+                    return false;
+            }
+
+            return true;
+        };
+
+        while (true)
+        {
+            if (Offset == Bytes.size())
+                return false;
+
+            auto Initial = static_cast<unsigned char>(Bytes[Offset++]);
+            auto Type = static_cast<Major>(Initial >> 5);
+            unsigned Info = Initial & 0x1F;
+
+            // The break closing an indefinite container, not in between a key and its value
+
+            if (Initial == 0xFF)
+            {
+                if (!Depth || Levels[Depth - 1].Remaining != Indefinite || Levels[Depth - 1].Value || !Close() || !Unwind())
+                    return false;
+
+                if (!Depth)
+                    return true;
+
+                continue;
+            }
+
+            std::uint64_t Argument = Info;
+
+            if (Info >= 24 && Info <= 27)
+            {
+                if (!Read(std::size_t{1} << (Info - 24), Argument))
+                    return false;
+            }
+            else if (Info == 31 ? Type != Major::Array && Type != Major::Map : Info > 27)
+            {
+                return false;
+            }
+
+            // The tagged item follows and takes the place of the tag
+
+            if (Type == Major::Tag)
+                continue;
+
+            bool Key = false;
+
+            if (Depth)
+            {
+                auto &Top = Levels[Depth - 1];
+
+                Key = Top.Object && !Top.Value;
+                Top.Value = Top.Object && !Top.Value;
+
+                if (Top.Remaining != Indefinite)
+                    --Top.Remaining;
+            }
+
+            if (Key && Type != Major::Text)
+                return false;
+
+            switch (Type)
+            {
+            case Major::Unsigned:
+                if (Argument > INT64_MAX ? !Sax::Emit([&]
+                                                      { return Handler.Double(static_cast<double>(Argument)); })
+                                         : !Sax::Emit([&]
+                                                      { return Handler.Integer(static_cast<std::int64_t>(Argument)); }))
+                    return false;
+
+                break;
+            case Major::Negative:
+                if (Argument > INT64_MAX ? !Sax::Emit([&]
+                                                      { return Handler.Double(-1.0 - static_cast<double>(Argument)); })
+                                         : !Sax::Emit([&]
+                                                      { return Handler.Integer(-1 - static_cast<std::int64_t>(Argument)); }))
+                    return false;
+
+                break;
+            case Major::Text:
+            {
+                if (Argument > Bytes.size() - Offset)
+                    return false;
+
+                auto View = Bytes.substr(Offset, Argument);
+
+                Offset += Argument;
+
+                if (!Sax::Text(View, Escape::Ascii(View) || Escape::Utf8(View) ? Escape::Kind::Plain : Escape::Kind::Invalid, Key, Handler, Scratch))
+                    return false;
+
+                break;
+            }
+            case Major::Array:
+            case Major::Map:
+            {
+                bool Object = Type == Major::Map;
+
+                if (!(Object ? Sax::Emit([&]
+                                         { return Handler.StartObject(); })
+                             : Sax::Emit([&]
+                                         { return Handler.StartArray(); })))
+                    return false;
+
+                if (Depth == Sax::MaxDepth || (Info != 31 && Argument > (Bytes.size() - Offset) / (Object ? 2 : 1)))
+                    return false;
+
+                Levels[Depth++] = {Info == 31 ? Indefinite : Object ? Argument * 2 : Argument, Object, false};
+
+                break;
+            }
+            case Major::Simple:
+            {
+                bool Reported = true;
+
+                if (Info == 20 || Info == 21)
+                    Reported = Sax::Emit([&]
+                                         { return Handler.Boolean(Info == 21); });
+                else if (Info == 22 || Info == 23)
+                    Reported = Sax::Emit([&]
+                                         { return Handler.Null(); });
+                else if (Info == 25)
+                    Reported = Sax::Emit([&]
+                                         { return Handler.Double(Half(static_cast<std::uint16_t>(Argument))); });
+                else if (Info == 26)
+                    Reported = Sax::Emit([&]
+                                         { return Handler.Double(std::bit_cast<float>(static_cast<std::uint32_t>(Argument))); });
+                else if (Info == 27)
+                    Reported = Sax::Emit([&]
+                                         { return Handler.Double(std::bit_cast<double>(Argument)); });
+                else
+                    return false;
+
+                if (!Reported)
+                    return false;
+
+                break;
+            }
+            default:
+                return false;
+            }
+
+            if (!Unwind())
+                return false;
+
+            if (!Depth)
+                return true;
+        }
+    }
+
+    // Same for a whole buffer, which has to consist of exactly one item
+
+    template <typename THandler>
+    bool Parse(std::string_view Bytes, THandler &Handler)
+    {
+        std::size_t Offset = 0;
+
+        return Parse(Bytes, Handler, Offset) && Offset == Bytes.size();
+    }
+
+    // Decodes Bytes into TDocument, either a strategy or a Json instantiation which is left
+    // empty when the root isn't a map. Strings of view types point into Bytes.
+
+    template <typename TDocument>
+    TDocument From(std::string_view Bytes, std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
+    {
+        if constexpr (requires { typename TDocument::Builder; })
+        {
+            typename TDocument::Builder Handler{Resource};
+
+            Parse(Bytes, Handler);
+
+            return Handler.Finish();
+        }
+        else
+        {
+            if (auto Root = From<typename TDocument::Value>(Bytes, Resource); Root.template Is<TDocument>())
+                return std::move(Root.template As<TDocument>());
+
+            if constexpr (std::is_constructible_v<TDocument, std::pmr::memory_resource *>)
+                return TDocument(Resource);
+            else
+                return TDocument{};
+        }
+    }
+}
@@ -0,0 +1,490 @@
+#pragma once
+
+#include <new>
+#include <tuple>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <variant>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <memory_resource>
+
+#include "../Json.hpp"
+
+// Strategy holding the same types as DefaultStrategy in 16 bytes instead of the size of the
+// largest of them. Types of up to 8 bytes that are trivially copyable, numbers, booleans and
+// null among them, are kept inline next to a one byte tag. Owning strings of up to 14 bytes
+// are copied inline as well, views keep pointing to the input instead. Objects, arrays, longer strings and any other type are boxed, that
+// is allocated out of line along with the resource they came from, the parse allocating
+// them from its own resource and the other constructors from the default one.
+//
+// Is, As, Visit, Index and operator[] behave as in Recursive, GetVariant isn't available as
+// there is no variant. Inline strings can't be referenced as the string type: the const As
+// and Visit hand out a copy of them, the non const ones box them first. A moved from value
+// is null.
+
+namespace Core
+{
+    template <typename T, typename... TO>
+    class CompactStrategy
+    {
+    public:
+        using Json = T;
+        using Array = typename T::Array;
+        using Traits = DefaultStrategy<T, TO...>;
+        using Builder = typename Traits::template Building<CompactStrategy>;
+
+        constexpr static bool Boxes = true;
+
+        CompactStrategy()
+        {
+            Emplace(typename FirstWhere<Traits::template is_null, TO...>::type{nullptr}, nullptr);
+        }
+
+        // Values of one of the types are boxed on Resource when they don't fit inline
+
+        template <typename TItem>
+        CompactStrategy(TItem &&Item, std::pmr::memory_resource *Resource)
+            requires(Contains<std::decay_t<TItem>, T, Array, TO...>::value)
+        {
+            Emplace(std::forward<TItem>(Item), Resource);
+        }
+
+        // Other values are converted the way DefaultStrategy does
+
+        template <typename TItem>
+        CompactStrategy(TItem &&Item)
+            requires(!std::is_same_v<std::decay_t<TItem>, CompactStrategy>)
+        {
+            using Type = typename decltype(Traits::template Strategy<std::decay_t<TItem>>())::type;
+
+            if constexpr (std::is_same_v<std::decay_t<TItem>, Type>)
+                Emplace(std::forward<TItem>(Item), std::pmr::get_default_resource());
+            else
+                Emplace(Type(std::forward<TItem>(Item)), std::pmr::get_default_resource());
+        }
+
+        CompactStrategy(CompactStrategy const &Other)
+        {
+            if (Other.Boxed())
+                Other.Dispatch([&](auto const &Item)
+                               { Emplace(Item, std::pmr::get_default_resource()); });
+            else
+                std::memcpy(static_cast<void *>(this), &Other, sizeof(CompactStrategy));
+        }
+
+        CompactStrategy(CompactStrategy &&Other) noexcept
+        {
+            std::memcpy(static_cast<void *>(this), &Other, sizeof(CompactStrategy));
+
+            Other.Reset();
+        }
+
+        CompactStrategy &operator=(CompactStrategy const &Other)
+        {
+            if (this != &Other)
+                *this = CompactStrategy(Other);
+
+            return *this;
+        }
+
+        CompactStrategy &operator=(CompactStrategy &&Other) noexcept
+        {
+            if (this != &Other)
+            {
+                Release();
+                std::memcpy(static_cast<void *>(this), &Other, sizeof(CompactStrategy));
+                Other.Reset();
+            }
+
+            return *this;
+        }
+
+        template <typename TItem>
+        CompactStrategy &operator=(TItem &&Item)
+            requires(!std::is_same_v<std::decay_t<TItem>, CompactStrategy>)
+        {
+            return *this = CompactStrategy(std::forward<TItem>(Item));
+        }
+
+        ~CompactStrategy()
+        {
+            static_assert(sizeof(CompactStrategy) == 16);
+
+            Release();
+        }
+
+        // Parses as DefaultStrategy does, see Building
+
+        static CompactStrategy From(Structural::Cursor &Cursor, std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
+        {
+            return Builder::Parse(Cursor, Resource);
+        }
+
+        static CompactStrategy From(Structural::Cursor &Cursor, Statistics &Stats, std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
+        {
+            return Builder::Parse(Cursor, Stats, Resource);
+        }
+
+        static CompactStrategy From(Structural::Cursor &Cursor, Status &Failure, std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
+        {
+            return Builder::Parse(Cursor, Failure, Resource);
+        }
+
+        static Result<CompactStrategy> TryFrom(std::string_view sv, std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
+        {
+            return Builder::TryParse(sv, Resource);
+        }
+
+        template <typename Target>
+        bool Is() const
+        {
+            return Index() == Position<Target>();
+        }
+
+        template <template <typename> typename TCondition>
+        bool Is() const
+        {
+            using type = typename FirstWhere<TCondition, TO...>::type;
+
+            static_assert(!std::is_same_v<void, type>, "Variant contains no such type");
+
+            return Is<type>();
+        }
+
+        template <typename Target>
+        Target &As()
+        {
+            if (!Is<Target>())
+                throw std::bad_variant_access();
+
+            if constexpr (Shortens<Target>)
+            {
+                if (Tag & Short)
+                    Store(Target(Text()), std::pmr::get_default_resource());
+            }
+
+            return Get<Target>();
+        }
+
+        template <typename Target>
+        decltype(auto) As() const
+        {
+            if (!Is<Target>())
+                throw std::bad_variant_access();
+
+            if constexpr (Shortens<Target>)
+                return (Tag & Short) ? Target(Text()) : Get<Target>();
+            else
+                return Get<Target>();
+        }
+
+        // The text of a string without copying it, whether inline or boxed
+
+        std::string_view Text() const
+        {
+            if (Tag & Short)
+                return {Bytes, static_cast<std::size_t>(Bytes[Length])};
+
+            return std::string_view(Get<String>());
+        }
+
+        std::size_t Index() const
+        {
+            return Tag & ~Short;
+        }
+
+        CompactStrategy &operator[](typename T::Key const &Key)
+        {
+            if (!Is<T>())
+                throw std::invalid_argument("Object is not json");
+
+            return Get<T>().GetMap()[Key];
+        }
+
+        CompactStrategy &operator[](std::size_t Index)
+        {
+            if (!Is<Array>())
+                throw std::invalid_argument("Object is not array");
+
+            return Get<Array>()[Index];
+        }
+
+        // Lookups that neither throw nor insert, see Recursive::Find
+
+        CompactStrategy *Find(typename T::Key const &Key)
+        {
+            return const_cast<CompactStrategy *>(std::as_const(*this).Find(Key));
+        }
+
+        CompactStrategy const *Find(typename T::Key const &Key) const
+        {
+            if (!Is<T>())
+                return nullptr;
+
+            auto &Members = Get<T>().GetMap();
+            auto It = Members.find(Key);
+
+            return It != Members.end() ? &It->second : nullptr;
+        }
+
+        CompactStrategy *Find(std::size_t Index)
+        {
+            return const_cast<CompactStrategy *>(std::as_const(*this).Find(Index));
+        }
+
+        CompactStrategy const *Find(std::size_t Index) const
+        {
+            if (!Is<Array>() || Index >= Get<Array>().size())
+                return nullptr;
+
+            return &Get<Array>()[Index];
+        }
+
+        template <typename Target>
+        Target *TryAs()
+        {
+            return Is<Target>() ? &As<Target>() : nullptr;
+        }
+
+        template <typename Target>
+        Target const *TryAs() const
+        {
+            static_assert(!Shortens<Target>, "Inline strings have nothing to point to, see Text");
+
+            return Is<Target>() ? &Get<Target>() : nullptr;
+        }
+
+        template <typename Target>
+        std::optional<Target> TryGet(typename T::Key const &Key) const
+        {
+            if (auto Member = Find(Key); Member && Member->template Is<Target>())
+                return Member->template As<Target>();
+
+            return std::nullopt;
+        }
+
+        decltype(auto) Visit(auto &&Visitor)
+        {
+            if constexpr (Shortens<String>)
+            {
+                if (Tag & Short)
+                    As<String>();
+            }
+
+            return Dispatch(std::forward<decltype(Visitor)>(Visitor));
+        }
+
+        decltype(auto) Visit(auto &&Visitor) const
+        {
+            return Dispatch(std::forward<decltype(Visitor)>(Visitor));
+        }
+
+        bool operator==(CompactStrategy const &Other) const
+        {
+            if (Index() != Other.Index())
+                return false;
+
+            if constexpr (Shortens<String>)
+            {
+                if (Is<String>())
+                    return Text() == Other.Text();
+            }
+
+            return Dispatch([&](auto const &Item)
+                            { return Item == Other.template Get<std::decay_t<decltype(Item)>>(); });
+        }
+
+        template <typename Types>
+        bool operator==(Types const &Other) const
+            requires(!std::is_same_v<Types, CompactStrategy>)
+        {
+            return *this == CompactStrategy(Other);
+        }
+
+        template <typename TSerializer>
+        friend TSerializer &operator<<(TSerializer &os, CompactStrategy const &value)
+        {
+            return Traits::Write(os, value);
+        }
+
+    private:
+        using Types = std::tuple<T, Array, TO...>;
+        using String = typename FirstWhere<Traits::template is_string, TO...>::type;
+
+        template <std::size_t I>
+        using Alternative = std::tuple_element_t<I, Types>;
+
+        template <typename TItem>
+        struct Box
+        {
+            std::pmr::memory_resource *Resource;
+            TItem Item;
+        };
+
+        // Last byte of the storage when the string is inline
+
+        constexpr static std::size_t Length = 14;
+        constexpr static std::uint8_t Short = 0x80;
+
+        template <typename TItem>
+        constexpr static bool Inline = sizeof(TItem) <= 8 && alignof(TItem) <= 8 && std::is_trivially_copyable_v<TItem>;
+
+        // A view made out of inline text would point into Bytes, which the boxed value
+        // overwrites, so only strings owning their text are kept inline
+
+        template <typename TItem>
+        constexpr static bool Shortens = std::is_same_v<TItem, String> && !Inline<String> && !std::is_trivially_destructible_v<String> &&
+                                         std::is_constructible_v<String, std::string_view>;
+
+        alignas(8) char Bytes[15];
+        std::uint8_t Tag;
+
+        template <typename Target>
+        constexpr static std::size_t Position()
+        {
+            std::size_t Result = 0;
+
+            [&]<std::size_t... I>(std::index_sequence<I...>)
+            {
+                ((std::is_same_v<Target, Alternative<I>> ? (Result = I, true) : false) || ...);
+            }(std::make_index_sequence<std::tuple_size_v<Types>>{});
+
+            return Result;
+        }
+
+        bool Boxed() const
+        {
+            return !(Tag & Short) && Dispatch([]<typename TItem>(TItem const &)
+                                              { return !Inline<TItem>; });
+        }
+
+        template <typename TItem>
+        void Emplace(TItem &&Item, std::pmr::memory_resource *Resource)
+        {
+            using Type = std::decay_t<TItem>;
+
+            Tag = Position<Type>();
+
+            if constexpr (Inline<Type>)
+            {
+                new (Bytes) Type(std::forward<TItem>(Item));
+            }
+            else
+            {
+                if constexpr (Shortens<Type>)
+                {
+                    if (std::string_view Text(Item); Text.size() <= Length)
+                    {
+                        std::memcpy(Bytes, Text.data(), Text.size());
+                        Bytes[Length] = static_cast<char>(Text.size());
+                        Tag |= Short;
+
+                        return;
+                    }
+                }
+
+                Store(Type(std::forward<TItem>(Item)), Resource);
+            }
+        }
+
+        template <typename TItem>
+        void Store(TItem &&Item, std::pmr::memory_resource *Resource)
+        {
+            using Type = std::decay_t<TItem>;
+
+            auto Memory = Resource->allocate(sizeof(Box<Type>), alignof(Box<Type>));
+            auto Allocated = new (Memory) Box<Type>{Resource, std::forward<TItem>(Item)};
+
+            std::memcpy(Bytes, &Allocated, sizeof(Allocated));
+            Tag = Position<Type>();
+        }
+
+        template <typename Target>
+        Target &Get()
+        {
+            if constexpr (Inline<Target>)
+            {
+                return *std::launder(reinterpret_cast<Target *>(Bytes));
+            }
+            else
+            {
+                Box<Target> *Allocated;
+
+                std::memcpy(&Allocated, Bytes, sizeof(Allocated));
+
+                return Allocated->Item;
+            }
+        }
+
+        template <typename Target>
+        Target const &Get() const
+        {
+            return const_cast<CompactStrategy *>(this)->template Get<Target>();
+        }
+
+        // Calls Visitor with the value held, inline strings being handed out as a copy
+
+        template <std::size_t I = 0>
+        decltype(auto) Dispatch(auto &&Visitor) const
+        {
+            using Type = Alternative<I>;
+
+            if constexpr (I + 1 < std::tuple_size_v<Types>)
+            {
+                if (Index() != I)
+                    return Dispatch<I + 1>(Visitor);
+            }
+
+            if constexpr (Shortens<Type>)
+            {
+                if (Tag & Short)
+                    return Visitor(static_cast<Type const &>(Type(Text())));
+            }
+
+            return Visitor(Get<Type>());
+        }
+
+        template <std::size_t I = 0>
+        decltype(auto) Dispatch(auto &&Visitor)
+        {
+            using Type = Alternative<I>;
+
+            if constexpr (I + 1 < std::tuple_size_v<Types>)
+            {
+                if (Index() != I)
+                    return Dispatch<I + 1>(Visitor);
+            }
+
+            return Visitor(Get<Type>());
+        }
+
+        void Release()
+        {
+            if (!Boxed())
+                return;
+
+            Dispatch([&]<typename TItem>(TItem &)
+                     {
+                         if constexpr (!Inline<TItem>)
+                         {
+                             Box<TItem> *Allocated;
+
+                             std::memcpy(&Allocated, Bytes, sizeof(Allocated));
+
+                             auto Resource = Allocated->Resource;
+
+                             Allocated->~Box<TItem>();
+                             Resource->deallocate(Allocated, sizeof(Box<TItem>), alignof(Box<TItem>));
+                         } });
+        }
+
+        void Reset()
+        {
+            Emplace(typename FirstWhere<Traits::template is_null, TO...>::type{nullptr}, nullptr);
+        }
+    };
+}
@@ -0,0 +1,669 @@
+#pragma once
+
+#include <array>
+#include <iterator>
+#include <limits>
+#include <cstdint>
+#include <utility>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+// Documents parsed while compiling. Core::Constant::From<STRINGIFY({...})> is a read only
+// document living in the binary, built by a constexpr parser walking the literal twice, once
+// to count its values and once to fill an array of that size. Malformed literals fail to
+// compile, as do strings holding escapes since strings are views into the literal and numbers
+// too large for a double. The nodes are laid out like the Tape, containers record the index
+// following them and object members are their key followed by the value, and are read through
+// the same kind of views, which are usable in constant expressions:
+//
+//     constexpr auto &Defaults = Core::Constant::From<STRINGIFY({"Port" : 8080})>;
+//     constexpr auto Port = Defaults["Port"].As<std::int64_t>();
+
+namespace Core::Constant
+{
+    // Literal used as a template argument, the parsed strings point into it
+
+    template <std::size_t Size>
+    struct Text
+    {
+        char Data[Size];
+
+        consteval Text(char const (&Literal)[Size])
+        {
+            for (std::size_t i = 0; i < Size; ++i)
+                Data[i] = Literal[i];
+        }
+
+        constexpr std::string_view View() const
+        {
+            return {Data, Size - 1};
+        }
+    };
+
+    enum class Kind : std::uint8_t
+    {
+        Object,
+        Array,
+        String,
+        Integer,
+        Double,
+        Boolean,
+        Null
+    };
+
+    struct Node
+    {
+        Kind Type = Kind::Null;
+
+        // Index of the node following this one and its children, and the number of children
+
+        std::uint32_t Next = 0;
+        std::uint32_t Count = 0;
+
+        std::string_view String = {};
+        std::int64_t Integer = 0;
+        double Double = 0;
+    };
+
+    class Value;
+    class Object;
+    class Array;
+
+    // Recursive descent over the bytes of the literal. Without Nodes it only counts them.
+
+    class Parser
+    {
+    public:
+        constexpr Parser(std::string_view Source, Node *Nodes = nullptr)
+            : Source(Source), Nodes(Nodes)
+        {
+        }
+
+        constexpr std::size_t Parse()
+        {
+            Element();
+            Space();
+
+            if (Offset != Source.size())
+                throw std::invalid_argument("Trailing characters after the value");
+
+            return Count;
+        }
+
+    private:
+        std::string_view Source;
+        Node *Nodes;
+
+        std::size_t Offset = 0;
+        std::size_t Count = 0;
+
+        constexpr char Peek() const
+        {
+            return Offset < Source.size() ? Source[Offset] : '\0';
+        }
+
+        constexpr void Space()
+        {
+            while (Peek() == ' ' || Peek() == '\n' || Peek() == '\r' || Peek() == '\t')
+                ++Offset;
+        }
+
+        constexpr void Expect(char c)
+        {
+            Space();
+
+            if (Peek() != c)
+                throw std::invalid_argument("Unexpected character");
+
+            ++Offset;
+        }
+
+        constexpr std::size_t Add(Node Item)
+        {
+            Item.Next = Count + 1;
+
+            if (Nodes)
+                Nodes[Count] = Item;
+
+            return Count++;
+        }
+
+        constexpr std::string_view String()
+        {
+            Expect('"');
+
+            std::size_t Start = Offset;
+
+            while (Peek() != '"')
+            {
+                if (Offset >= Source.size())
+                    throw std::invalid_argument("Unterminated string");
+
+                if (Peek() == '\\')
+                    throw std::invalid_argument("Escapes in strings aren't supported, they would be kept undecoded");
+
+                if (static_cast<unsigned char>(Peek()) < 0x20)
+                    throw std::invalid_argument("Control character in string");
+
+                ++Offset;
+            }
+
+            return Source.substr(Start, Offset++ - Start);
+        }
+
+        constexpr void Close(std::size_t Index, std::uint32_t Children)
+        {
+            if (Nodes)
+            {
+                Nodes[Index].Next = Count;
+                Nodes[Index].Count = Children;
+            }
+        }
+
+        constexpr void Element()
+        {
+            Space();
+
+            char Token = Peek();
+
+            if (Token == '{')
+            {
+                std::size_t Index = Add({Kind::Object});
+                std::uint32_t Children = 0;
+
+                ++Offset;
+                Space();
+
+                while (Peek() != '}')
+                {
+                    Add({.Type = Kind::String, .String = String()});
+                    Expect(':');
+                    Element();
+                    Space();
+
+                    ++Children;
+
+                    if (Peek() != ',')
+                        break;
+
+                    ++Offset;
+                    Space();
+
+                    if (Peek() == '}')
+                        throw std::invalid_argument("Trailing comma");
+                }
+
+                Expect('}');
+                Close(Index, Children);
+            }
+            else if (Token == '[')
+            {
+                std::size_t Index = Add({Kind::Array});
+                std::uint32_t Children = 0;
+
+                ++Offset;
+                Space();
+
+                while (Peek() != ']')
+                {
+                    Element();
+                    Space();
+
+                    ++Children;
+
+                    if (Peek() != ',')
+                        break;
+
+                    ++Offset;
+                    Space();
+
+                    if (Peek() == ']')
+                        throw std::invalid_argument("Trailing comma");
+                }
+
+                Expect(']');
+                Close(Index, Children);
+            }
+            else if (Token == '"')
+            {
+                Add({.Type = Kind::String, .String = String()});
+            }
+            else if (Source.substr(Offset, 4) == "null")
+            {
+                Offset += 4;
+                Add({Kind::Null});
+            }
+            else if (Source.substr(Offset, 4) == "true")
+            {
+                Offset += 4;
+                Add({.Type = Kind::Boolean, .Integer = 1});
+            }
+            else if (Source.substr(Offset, 5) == "false")
+            {
+                Offset += 5;
+                Add({Kind::Boolean});
+            }
+            else
+            {
+                Number();
+            }
+        }
+
+        constexpr bool Digit() const
+        {
+            return Peek() >= '0' && Peek() <= '9';
+        }
+
+        // Exact when the digits fit in 53 bits and the decimal exponent is within 22, both
+        // operands of the final multiplication or division then being representable. Other
+        // numbers may be off by the last bit.
+
+        constexpr void Number()
+        {
+            bool Negative = Peek() == '-';
+            bool Integral = true;
+            bool Overflow = false;
+
+            std::uint64_t Mantissa = 0;
+            std::int64_t Exponent = 0;
+
+            Offset += Negative;
+
+            if (!Digit())
+                throw std::invalid_argument("Invalid value");
+
+            if (Peek() == '0' && Offset + 1 < Source.size() && Source[Offset + 1] >= '0' && Source[Offset + 1] <= '9')
+                throw std::invalid_argument("Leading zero");
+
+            auto Accumulate = [&](std::int64_t Shift)
+            {
+                while (Digit())
+                {
+                    if (Mantissa < 1'000'000'000'000'000'000ULL)
+                    {
+                        Mantissa = Mantissa * 10 + (Peek() - '0');
+                        Exponent += Shift;
+                    }
+                    else
+                    {
+                        Overflow = true;
+                        Exponent += 1 + Shift;
+                    }
+
+                    ++Offset;
+                }
+            };
+
+            Accumulate(0);
+
+            if (Peek() == '.')
+            {
+                ++Offset;
+                Integral = false;
+
+                if (!Digit())
+                    throw std::invalid_argument("Invalid number");
+
+                Accumulate(-1);
+            }
+
+            if (Peek() == 'e' || Peek() == 'E')
+            {
+                ++Offset;
+                Integral = false;
+
+                bool Minus = Peek() == '-';
+
+                if (Peek() == '-' || Peek() == '+')
+                    ++Offset;
+
+                if (!Digit())
+                    throw std::invalid_argument("Invalid number");
+
+                std::int64_t Written = 0;
+
+                while (Digit())
+                {
+                    Written = std::min<std::int64_t>(Written * 10 + (Peek() - '0'), 100000);
+                    ++Offset;
+                }
+
+                Exponent += Minus ? -Written : Written;
+            }
+
+            std::uint64_t Limit = std::uint64_t(std::numeric_limits<std::int64_t>::max()) + Negative;
+
+            if (Integral && !Overflow && Mantissa <= Limit)
+            {
+                Add({.Type = Kind::Integer, .Integer = Negative ? std::int64_t(0 - Mantissa) : std::int64_t(Mantissa)});
+                return;
+            }
+
+            // Scales by the binary decomposition of the exponent, each power being a correctly
+            // rounded literal. The scale is applied early when it would overflow, numbers too
+            // small for a double round to zero as in the other parsers while too large ones
+            // are rejected, infinity not being a constant.
+
+            constexpr double Powers[] = {1e1, 1e2, 1e4, 1e8, 1e16, 1e32, 1e64, 1e128, 1e256};
+            constexpr double Largest = std::numeric_limits<double>::max();
+
+            double Result = double(Mantissa);
+            double Scale = 1;
+
+            std::int64_t Magnitude = Exponent < 0 ? -Exponent : Exponent;
+
+            auto Apply = [&]
+            {
+                if (Exponent > 0 && Result > Largest / Scale)
+                    throw std::invalid_argument("Number out of range");
+
+                Result = Exponent < 0 ? Result / Scale : Result * Scale;
+                Scale = 1;
+            };
+
+            // Beyond the powers of the table the digits, being at most 19, can't make up for it
+
+            if (Magnitude >= 512)
+            {
+                if (Exponent > 0 && Result)
+                    throw std::invalid_argument("Number out of range");
+
+                Result = 0;
+                Magnitude = 0;
+            }
+
+            for (std::size_t i = 0; i < std::size(Powers) && Magnitude; ++i, Magnitude >>= 1)
+            {
+                if (Magnitude & 1)
+                {
+                    if (Scale > Largest / Powers[i])
+                        Apply();
+
+                    Scale *= Powers[i];
+                }
+            }
+
+            Apply();
+
+            Add({.Type = Kind::Double, .Double = Negative ? -Result : Result});
+        }
+    };
+
+    class Value
+    {
+    public:
+        constexpr Value(Node const *Nodes, std::size_t Index)
+            : Nodes(Nodes), Position(Index)
+        {
+        }
+
+        template <typename Target>
+        constexpr bool Is() const
+        {
+            static_assert(Alternative<Target>, "Constant values hold no such type");
+
+            Kind Type = Nodes[Position].Type;
+
+            if constexpr (std::is_same_v<Target, Object>)
+                return Type == Kind::Object;
+            else if constexpr (std::is_same_v<Target, Array>)
+                return Type == Kind::Array;
+            else if constexpr (std::is_same_v<Target, std::string_view>)
+                return Type == Kind::String;
+            else if constexpr (std::is_same_v<Target, std::int64_t>)
+                return Type == Kind::Integer;
+            else if constexpr (std::is_same_v<Target, double>)
+                return Type == Kind::Double;
+            else if constexpr (std::is_same_v<Target, bool>)
+                return Type == Kind::Boolean;
+            else
+                return Type == Kind::Null;
+        }
+
+        template <typename Target>
+        constexpr Target As() const
+        {
+            if (!Is<Target>())
+                throw std::invalid_argument("Value holds another type");
+
+            Node const &Item = Nodes[Position];
+
+            if constexpr (std::is_same_v<Target, Object> || std::is_same_v<Target, Array>)
+                return Target{Nodes, Position};
+            else if constexpr (std::is_same_v<Target, std::string_view>)
+                return Item.String;
+            else if constexpr (std::is_same_v<Target, std::int64_t>)
+                return Item.Integer;
+            else if constexpr (std::is_same_v<Target, double>)
+                return Item.Double;
+            else if constexpr (std::is_same_v<Target, bool>)
+                return Item.Integer != 0;
+            else
+                return nullptr;
+        }
+
+        constexpr inline Value operator[](std::string_view Key) const;
+
+        constexpr inline Value operator[](std::size_t Index) const;
+
+        template <typename TVisitor>
+        constexpr decltype(auto) Visit(TVisitor &&Visitor) const
+        {
+            switch (Nodes[Position].Type)
+            {
+            case Kind::Object:
+                return Visitor(As<Object>());
+            case Kind::Array:
+                return Visitor(As<Array>());
+            case Kind::String:
+                return Visitor(As<std::string_view>());
+            case Kind::Integer:
+                return Visitor(As<std::int64_t>());
+            case Kind::Double:
+                return Visitor(As<double>());
+            case Kind::Boolean:
+                return Visitor(As<bool>());
+            default:
+                return Visitor(nullptr);
+            }
+        }
+
+    private:
+        template <typename Target>
+        constexpr static bool Alternative = std::is_same_v<Target, Object> || std::is_same_v<Target, Array> ||
+                                            std::is_same_v<Target, std::string_view> || std::is_same_v<Target, std::int64_t> ||
+                                            std::is_same_v<Target, double> || std::is_same_v<Target, bool> ||
+                                            std::is_same_v<Target, std::nullptr_t>;
+
+        Node const *Nodes;
+        std::size_t Position;
+    };
+
+    // Walks the children of a container, Step being 1 for objects whose values follow their key
+
+    template <typename TItem, std::size_t Step>
+    class Iterator
+    {
+    public:
+        constexpr Iterator(Node const *Nodes, std::size_t Index)
+            : Nodes(Nodes), Position(Index)
+        {
+        }
+
+        constexpr TItem operator*() const
+        {
+            if constexpr (Step)
+                return {Nodes[Position].String, Value{Nodes, Position + Step}};
+            else
+                return Value{Nodes, Position};
+        }
+
+        constexpr Iterator &operator++()
+        {
+            Position = Nodes[Position + Step].Next;
+
+            return *this;
+        }
+
+        constexpr bool operator==(Iterator const &Other) const
+        {
+            return Position == Other.Position;
+        }
+
+    private:
+        Node const *Nodes;
+        std::size_t Position;
+    };
+
+    class Object
+    {
+    public:
+        using Member = std::pair<std::string_view, Value>;
+
+        constexpr Object(Node const *Nodes, std::size_t Index)
+            : Nodes(Nodes), Position(Index)
+        {
+        }
+
+        constexpr Iterator<Member, 1> begin() const
+        {
+            return {Nodes, Position + 1};
+        }
+
+        constexpr Iterator<Member, 1> end() const
+        {
+            return {Nodes, Nodes[Position].Next};
+        }
+
+        constexpr std::size_t Size() const
+        {
+            return Nodes[Position].Count;
+        }
+
+        constexpr bool Empty() const
+        {
+            return !Size();
+        }
+
+        constexpr bool Contains(std::string_view Key) const
+        {
+            for (auto [Name, Member] : *this)
+            {
+                if (Name == Key)
+                    return true;
+            }
+
+            return false;
+        }
+
+        constexpr Value operator[](std::string_view Key) const
+        {
+            for (auto [Name, Member] : *this)
+            {
+                if (Name == Key)
+                    return Member;
+            }
+
+            throw std::out_of_range("No such key");
+        }
+
+    private:
+        Node const *Nodes;
+        std::size_t Position;
+    };
+
+    class Array
+    {
+    public:
+        constexpr Array(Node const *Nodes, std::size_t Index)
+            : Nodes(Nodes), Position(Index)
+        {
+        }
+
+        constexpr Iterator<Value, 0> begin() const
+        {
+            return {Nodes, Position + 1};
+        }
+
+        constexpr Iterator<Value, 0> end() const
+        {
+            return {Nodes, Nodes[Position].Next};
+        }
+
+        constexpr std::size_t Size() const
+        {
+            return Nodes[Position].Count;
+        }
+
+        constexpr bool Empty() const
+        {
+            return !Size();
+        }
+
+        constexpr Value operator[](std::size_t Index) const
+        {
+            for (auto Item : *this)
+            {
+                if (!Index--)
+                    return Item;
+            }
+
+            throw std::out_of_range("Index out of range");
+        }
+
+    private:
+        Node const *Nodes;
+        std::size_t Position;
+    };
+
+    constexpr Value Value::operator[](std::string_view Key) const
+    {
+        if (!Is<Object>())
+            throw std::invalid_argument("Object is not json");
+
+        return Object{Nodes, Position}[Key];
+    }
+
+    constexpr Value Value::operator[](std::size_t Index) const
+    {
+        if (!Is<Array>())
+            throw std::invalid_argument("Object is not array");
+
+        return Array{Nodes, Position}[Index];
+    }
+
+    template <std::size_t Size>
+    struct Document
+    {
+        std::array<Node, Size> Nodes;
+
+        constexpr Value Root() const
+        {
+            return {Nodes.data(), 0};
+        }
+
+        constexpr Value operator[](std::string_view Key) const
+        {
+            return Root()[Key];
+        }
+
+        constexpr Value operator[](std::size_t Index) const
+        {
+            return Root()[Index];
+        }
+    };
+
+    template <Text Source>
+    consteval auto Parse()
+    {
+        Document<Parser{Source.View()}.Parse()> Result{};
+
+        Parser{Source.View(), Result.Nodes.data()}.Parse();
+
+        return Result;
+    }
+
+    template <Text Source>
+    inline constexpr auto From = Parse<Source>();
+}
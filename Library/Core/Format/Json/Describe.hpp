@@ -0,0 +1,45 @@
+#pragma once
+
+#include <tuple>
+#include <cstddef>
+#include <utility>
+#include <string_view>
+
+// Field descriptions of user types, which let the binder and the writer read and write them
+// without going through a tree. A type is described by specializing Core::Describe with a
+// tuple of the Json names of its members and pointers to them:
+//
+//     template <>
+//     struct Core::Describe<Point>
+//     {
+//         constexpr static std::tuple Fields{Core::Field{"X", &Point::X}, Core::Field{"Y", &Point::Y}};
+//     };
+
+namespace Core
+{
+    template <typename TClass, typename TMember>
+    struct Field
+    {
+        std::string_view Name;
+        TMember TClass::*Member;
+    };
+
+    template <typename T>
+    struct Describe
+    {
+    };
+
+    template <typename T>
+    concept Described = requires { std::tuple_size<std::decay_t<decltype(Describe<T>::Fields)>>::value; };
+
+    // Calls Callback(Name, Member) for every described member of Object, in declaration order
+
+    template <typename T, typename TCallback>
+        requires Described<std::remove_const_t<T>>
+    constexpr void Members(T &Object, TCallback &&Callback)
+    {
+        std::apply([&](auto const &...Fields)
+                   { (Callback(Fields.Name, Object.*(Fields.Member)), ...); },
+                   Describe<std::remove_const_t<T>>::Fields);
+    }
+}
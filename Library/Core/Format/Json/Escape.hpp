@@ -0,0 +1,716 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <memory_resource>
+
+#include "Structural.hpp"
+
+// String contents in both directions. Reading, the raw text between the quotes is classified
+// 32 bytes at a time to find out whether it holds escapes, control characters or anything
+// outside of ASCII, the latter only then being checked to be valid UTF-8. Strings without
+// escapes are used as they are, the others are decoded, \uXXXX surrogate pairs included.
+// Writing, runs of characters which need no escaping are found the same way and copied whole.
+
+namespace Core::Escape
+{
+    // Bit i of each mask describes byte i of the 32 byte block
+
+    struct Bytes
+    {
+        std::uint32_t Quote;
+        std::uint32_t Backslash;
+        std::uint32_t Control;
+        std::uint32_t High;
+    };
+
+    inline Bytes ClassifyScalar(char const *Data)
+    {
+        Bytes Result{};
+
+        for (std::size_t i = 0; i < 32; ++i)
+        {
+            std::uint32_t Bit = std::uint32_t{1} << i;
+            auto c = static_cast<unsigned char>(Data[i]);
+
+            if (c == '"')
+                Result.Quote |= Bit;
+            else if (c == '\\')
+                Result.Backslash |= Bit;
+            else if (c < 0x20)
+                Result.Control |= Bit;
+            else if (c >= 0x80)
+                Result.High |= Bit;
+        }
+
+        return Result;
+    }
+
+#ifdef CORE_JSON_X86
+
+    __attribute__((target("sse4.2"))) inline Bytes ClassifySse42(char const *Data)
+    {
+        Bytes Result{};
+
+        for (int i = 0; i < 2; ++i)
+        {
+            __m128i Chunk = _mm_loadu_si128(reinterpret_cast<__m128i const *>(Data + i * 16));
+
+            // Unsigned c <= 0x1F is max(c, 0x1F) == 0x1F
+
+            __m128i Control = _mm_cmpeq_epi8(_mm_max_epu8(Chunk, _mm_set1_epi8(0x1F)), _mm_set1_epi8(0x1F));
+
+            Result.Quote |= std::uint32_t(std::uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(Chunk, _mm_set1_epi8('"'))))) << (i * 16);
+            Result.Backslash |= std::uint32_t(std::uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(Chunk, _mm_set1_epi8('\\'))))) << (i * 16);
+            Result.Control |= std::uint32_t(std::uint16_t(_mm_movemask_epi8(Control))) << (i * 16);
+            Result.High |= std::uint32_t(std::uint16_t(_mm_movemask_epi8(Chunk))) << (i * 16);
+        }
+
+        return Result;
+    }
+
+    __attribute__((target("avx2"))) inline Bytes ClassifyAvx2(char const *Data)
+    {
+        __m256i Chunk = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(Data));
+        __m256i Control = _mm256_cmpeq_epi8(_mm256_max_epu8(Chunk, _mm256_set1_epi8(0x1F)), _mm256_set1_epi8(0x1F));
+
+        return {
+            std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(Chunk, _mm256_set1_epi8('"')))),
+            std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(Chunk, _mm256_set1_epi8('\\')))),
+            std::uint32_t(_mm256_movemask_epi8(Control)),
+            std::uint32_t(_mm256_movemask_epi8(Chunk))};
+    }
+
+#endif
+
+    inline Bytes Classify(char const *Data, Structural::Level Use)
+    {
+#ifdef CORE_JSON_X86
+        if (Use == Structural::Level::Avx2)
+            return ClassifyAvx2(Data);
+
+        if (Use == Structural::Level::Sse42)
+            return ClassifySse42(Data);
+#endif
+
+        return ClassifyScalar(Data);
+    }
+
+    // Loads the Size < 8 bytes at Data in fixed size pieces, the rest being padded with 'a'
+
+    inline std::uint64_t Tail(char const *Data, std::size_t Size)
+    {
+        std::uint64_t Word = 0;
+        std::size_t Filled = 0;
+
+        auto Load = [&]<typename TPiece>(TPiece)
+        {
+            TPiece Piece;
+
+            std::memcpy(&Piece, Data, sizeof(TPiece));
+
+            Word |= std::uint64_t(Piece) << Filled;
+            Filled += sizeof(TPiece) * 8;
+            Data += sizeof(TPiece);
+        };
+
+        if (Size & 4)
+            Load(std::uint32_t{});
+
+        if (Size & 2)
+            Load(std::uint16_t{});
+
+        if (Size & 1)
+            Load(std::uint8_t{});
+
+        return Word | 0x6161616161616161ULL << Filled;
+    }
+
+    // Calls Each(Masks, Offset) for every 32 byte block of Text, the last one being padded with
+    // characters of no interest. Each returning false stops the scan.
+
+    template <typename TEach>
+    inline void Blocks(std::string_view Text, TEach &&Each)
+    {
+        auto Use = Structural::Detect();
+
+        std::size_t Offset = 0;
+
+        for (; Offset + 32 <= Text.size(); Offset += 32)
+        {
+            if (!Each(Escape::Classify(Text.data() + Offset, Use), Offset))
+                return;
+        }
+
+        if (Offset < Text.size())
+        {
+            char Padded[32];
+
+            std::memset(Padded, 'a', 32);
+            std::memcpy(Padded, Text.data() + Offset, Text.size() - Offset);
+
+            Each(Escape::Classify(Padded, Use), Offset);
+        }
+    }
+
+    // Masks of Bytes which have a bit set anywhere within Text, without telling where. Whole
+    // blocks are ORed together and the bytes past the last one are checked 8 at a time within
+    // general purpose registers, which beats padding a block for the short strings most
+    // documents are made of.
+
+    inline Bytes Summarise(std::string_view Text)
+    {
+        constexpr std::uint64_t Ones = 0x0101010101010101ULL;
+        constexpr std::uint64_t Low = 0x7F * Ones;
+
+        auto Equal = [&](std::uint64_t Word, char c)
+        {
+            std::uint64_t Diff = Word ^ (static_cast<unsigned char>(c) * Ones);
+
+            return ~(((Diff & Low) + Low) | Diff | Low);
+        };
+
+        Bytes Result{};
+        std::size_t Offset = 0;
+
+        if (Text.size() >= 32)
+        {
+            auto Use = Structural::Detect();
+
+            for (; Offset + 32 <= Text.size(); Offset += 32)
+            {
+                auto Masks = Escape::Classify(Text.data() + Offset, Use);
+
+                Result.Quote |= Masks.Quote;
+                Result.Backslash |= Masks.Backslash;
+                Result.Control |= Masks.Control;
+                Result.High |= Masks.High;
+            }
+        }
+
+        std::uint64_t Quote = 0, Backslash = 0, Control = 0, High = 0;
+
+        auto Check = [&](std::uint64_t Word)
+        {
+            // Bytes below 0x20 don't carry into the high bit once 0x60 is added to their low bits
+
+            Quote |= Equal(Word, '"');
+            Backslash |= Equal(Word, '\\');
+            Control |= ~(((Word & Low) + 0x60 * Ones) | Word);
+            High |= Word;
+        };
+
+        auto Load = [&](std::size_t At)
+        {
+            std::uint64_t Word;
+
+            std::memcpy(&Word, Text.data() + At, 8);
+
+            return Word;
+        };
+
+        // Only whether something was found matters, so the last word may overlap the previous one
+
+        if (Text.size() - Offset >= 8)
+        {
+            for (; Offset + 8 < Text.size(); Offset += 8)
+                Check(Load(Offset));
+
+            Check(Load(Text.size() - 8));
+        }
+        else if (Offset < Text.size())
+        {
+            Check(Tail(Text.data() + Offset, Text.size() - Offset));
+        }
+
+        constexpr std::uint64_t Top = 0x80 * Ones;
+
+        Result.Quote |= (Quote & Top) != 0;
+        Result.Backslash |= (Backslash & Top) != 0;
+        Result.Control |= (Control & Top) != 0;
+        Result.High |= (High & Top) != 0;
+
+        return Result;
+    }
+
+    // Scalar check of one multi byte sequence starting at Text[i], its length or 0 if invalid
+
+    inline std::size_t Sequence(std::string_view Text, std::size_t i)
+    {
+        auto At = [&](std::size_t j)
+        {
+            return j < Text.size() ? static_cast<unsigned char>(Text[j]) : 0u;
+        };
+
+        auto Continuation = [&](std::size_t j)
+        {
+            return (At(j) & 0xC0) == 0x80;
+        };
+
+        unsigned char c = At(i);
+
+        if (c >= 0xC2 && c <= 0xDF)
+            return Continuation(i + 1) ? 2 : 0;
+
+        // Overlong forms, surrogates and code points past U+10FFFF are rejected on the second byte
+
+        if (c >= 0xE0 && c <= 0xEF)
+        {
+            unsigned char Low = c == 0xE0 ? 0xA0 : 0x80, High = c == 0xED ? 0x9F : 0xBF;
+
+            return At(i + 1) >= Low && At(i + 1) <= High && Continuation(i + 2) ? 3 : 0;
+        }
+
+        if (c >= 0xF0 && c <= 0xF4)
+        {
+            unsigned char Low = c == 0xF0 ? 0x90 : 0x80, High = c == 0xF4 ? 0x8F : 0xBF;
+
+            return At(i + 1) >= Low && At(i + 1) <= High && Continuation(i + 2) && Continuation(i + 3) ? 4 : 0;
+        }
+
+        return 0;
+    }
+
+    // Whether Text only holds ASCII, looked at 8 bytes at a time. Cheaper than Summarise for
+    // short strings whose other bytes don't matter.
+
+    inline bool Ascii(std::string_view Text)
+    {
+        constexpr std::uint64_t High = 0x8080808080808080ULL;
+
+        std::uint64_t Found = 0;
+        std::size_t i = 0;
+
+        for (; i + 8 <= Text.size(); i += 8)
+        {
+            std::uint64_t Word;
+            std::memcpy(&Word, Text.data() + i, 8);
+
+            Found |= Word;
+        }
+
+        for (; i < Text.size(); ++i)
+            Found |= static_cast<unsigned char>(Text[i]);
+
+        return !(Found & High);
+    }
+
+    // Whether Text is valid UTF-8, blocks of plain ASCII being skipped whole
+
+    inline bool Utf8(std::string_view Text)
+    {
+        bool Valid = true;
+        std::size_t Resume = 0;
+
+        Blocks(Text, [&](Bytes Masks, std::size_t Offset)
+               {
+                   // A sequence started in the previous block may run over into this one
+
+                   std::uint32_t High = Resume > Offset ? Masks.High & ~((std::uint32_t{1} << (Resume - Offset)) - 1) : Masks.High;
+
+                   while (High)
+                   {
+                       std::size_t i = Offset + std::countr_zero(High);
+                       std::size_t Length = Sequence(Text, i);
+
+                       if (!Length)
+                           return Valid = false;
+
+                       Resume = i + Length;
+
+                       High = Resume - Offset >= 32 ? 0 : High & ~((std::uint32_t{1} << (Resume - Offset)) - 1);
+                   }
+
+                   return true; });
+
+        return Valid;
+    }
+
+    enum class Kind
+    {
+        Plain,
+        Escaped,
+        Invalid
+    };
+
+    // Looks at the raw content of a string once : Plain strings can be used as they are,
+    // Escaped ones have to go through Decode and Invalid ones hold control characters or
+    // malformed UTF-8
+
+    inline Kind Classify(std::string_view Raw)
+    {
+        auto Found = Summarise(Raw);
+
+        if (Found.Control || (Found.High && !Utf8(Raw)))
+            return Kind::Invalid;
+
+        return Found.Backslash ? Kind::Escaped : Kind::Plain;
+    }
+
+    // Same for a string read through the cursor, skipping the scan for inputs the structural
+    // index found to only hold plain strings. Unterminated strings are Invalid.
+
+    inline Kind Classify(std::string_view Raw, Structural::Cursor const &Cursor)
+    {
+        if (!Cursor.Closed(Raw))
+            return Kind::Invalid;
+
+        return Cursor.Plain() ? Kind::Plain : Classify(Raw);
+    }
+
+    constexpr std::size_t Invalid = std::size_t(-1);
+
+    constexpr int Hex(char c)
+    {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+
+        if (c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+
+        return -1;
+    }
+
+    // Decodes the raw content of a string into Out, which needs room for Raw.size() characters
+    // as decoding never grows a string. Returns the decoded size, Invalid on malformed escapes.
+    // Without Write the escapes are only checked and Out is left alone.
+
+    template <bool Write = true>
+    constexpr std::size_t Decode(std::string_view Raw, char *Out)
+    {
+        std::size_t Size = 0;
+
+        auto Put = [&](char c)
+        {
+            if constexpr (Write)
+                Out[Size] = c;
+
+            ++Size;
+        };
+
+        auto Unit = [&](std::size_t i)
+        {
+            int Result = 0;
+
+            for (std::size_t j = i; j < i + 4; ++j)
+            {
+                int Digit = j < Raw.size() ? Hex(Raw[j]) : -1;
+
+                if (Digit < 0)
+                    return -1;
+
+                Result = Result << 4 | Digit;
+            }
+
+            return Result;
+        };
+
+        for (std::size_t i = 0; i < Raw.size(); ++i)
+        {
+            if (Raw[i] != '\\')
+            {
+                Put(Raw[i]);
+                continue;
+            }
+
+            if (++i == Raw.size())
+                return Invalid;
+
+            switch (Raw[i])
+            {
+            case '"':
+            case '\\':
+            case '/':
+                Put(Raw[i]);
+                break;
+            case 'b':
+                Put('\b');
+                break;
+            case 'f':
+                Put('\f');
+                break;
+            case 'n':
+                Put('\n');
+                break;
+            case 'r':
+                Put('\r');
+                break;
+            case 't':
+                Put('\t');
+                break;
+            case 'u':
+            {
+                long Point = Unit(i + 1);
+
+                if (Point < 0)
+                    return Invalid;
+
+                i += 4;
+
+                // High surrogates have to be followed by an escaped low surrogate
+
+                if (Point >= 0xD800 && Point <= 0xDBFF)
+                {
+                    long Low = i + 2 < Raw.size() && Raw[i + 1] == '\\' && Raw[i + 2] == 'u' ? Unit(i + 3) : -1;
+
+                    if (Low < 0xDC00 || Low > 0xDFFF)
+                        return Invalid;
+
+                    Point = 0x10000 + ((Point - 0xD800) << 10) + (Low - 0xDC00);
+                    i += 6;
+                }
+                else if (Point >= 0xDC00 && Point <= 0xDFFF)
+                {
+                    return Invalid;
+                }
+
+                if (Point < 0x80)
+                {
+                    Put(static_cast<char>(Point));
+                }
+                else if (Point < 0x800)
+                {
+                    Put(static_cast<char>(0xC0 | Point >> 6));
+                    Put(static_cast<char>(0x80 | (Point & 0x3F)));
+                }
+                else if (Point < 0x10000)
+                {
+                    Put(static_cast<char>(0xE0 | Point >> 12));
+                    Put(static_cast<char>(0x80 | (Point >> 6 & 0x3F)));
+                    Put(static_cast<char>(0x80 | (Point & 0x3F)));
+                }
+                else
+                {
+                    Put(static_cast<char>(0xF0 | Point >> 18));
+                    Put(static_cast<char>(0x80 | (Point >> 12 & 0x3F)));
+                    Put(static_cast<char>(0x80 | (Point >> 6 & 0x3F)));
+                    Put(static_cast<char>(0x80 | (Point & 0x3F)));
+                }
+
+                break;
+            }
+            default:
+                return Invalid;
+            }
+        }
+
+        return Size;
+    }
+
+    // Whether Make gave up on a well formed string because of where it would be decoded to,
+    // see below. Parsers report it instead of dropping the string, Require throwing when it
+    // does. Only called once Make failed, so checking the escapes again costs nothing usually.
+
+    template <typename TString>
+    bool Refuses(std::string_view Raw, bool Escaped, std::pmr::memory_resource *Resource)
+    {
+        if constexpr (requires { requires TString::Copies; } || !std::is_trivially_destructible_v<TString>)
+            return false;
+        else
+            return Escaped && Resource == std::pmr::new_delete_resource() && Decode<false>(Raw, nullptr) != Invalid;
+    }
+
+    [[noreturn]] inline void Refuse()
+    {
+        throw std::invalid_argument("Strings with escapes can't be kept as views on the heap, parse into an Arena");
+    }
+
+    template <typename TString>
+    void Require(std::string_view Raw, bool Escaped, std::pmr::memory_resource *Resource)
+    {
+        if (Refuses<TString>(Raw, Escaped, Resource))
+            Refuse();
+    }
+
+    // Builds a TString out of the raw content of a string, nullopt when its escapes are
+    // malformed. Owning strings receive the decoded text, allocated from Resource when they
+    // take an allocator. Views are zero copy without escapes and point into memory taken from
+    // Resource otherwise, which is never handed back. That needs a resource releasing it all
+    // at once, an arena typically, so views of strings with escapes are nullopt as well when
+    // Resource is the heap, see Refuses. Types declaring Copies, such as Core::Symbol, are
+    // built out of a temporary decoded copy.
+
+    template <typename TString>
+    std::optional<TString> Make(std::string_view Raw, bool Escaped, std::pmr::memory_resource *Resource)
+    {
+        constexpr bool Owning = !std::is_trivially_destructible_v<TString>;
+
+        if constexpr (requires { requires TString::Copies; })
+        {
+            if (Escaped)
+            {
+                std::string Decoded(Raw.size(), '\0');
+                auto Size = Decode(Raw, Decoded.data());
+
+                if (Size == Invalid)
+                    return std::nullopt;
+
+                return TString(std::string_view{Decoded.data(), Size});
+            }
+        }
+
+        if constexpr (!Owning)
+        {
+            if (Escaped && Resource == std::pmr::new_delete_resource())
+                return std::nullopt;
+        }
+
+        if (!Escaped)
+        {
+            if constexpr (std::is_constructible_v<TString, std::string_view, std::pmr::memory_resource *>)
+                return TString(Raw, Resource);
+            else
+                return TString(Raw);
+        }
+
+        if constexpr (Owning)
+        {
+            std::optional<TString> Result;
+
+            if constexpr (std::is_constructible_v<TString, std::size_t, char, std::pmr::memory_resource *>)
+                Result.emplace(Raw.size(), '\0', Resource);
+            else
+                Result.emplace(Raw.size(), '\0');
+
+            auto Size = Decode(Raw, Result->data());
+
+            if (Size == Invalid)
+                return std::nullopt;
+
+            Result->resize(Size);
+
+            return Result;
+        }
+        else
+        {
+            auto Storage = static_cast<char *>(Resource->allocate(Raw.size() ? Raw.size() : 1, 1));
+            auto Size = Decode(Raw, Storage);
+
+            if (Size == Invalid)
+                return std::nullopt;
+
+            return TString(std::string_view{Storage, Size});
+        }
+    }
+
+    // Whether Make copies the content out of the input for a string of the given kind
+
+    template <typename TString>
+    constexpr bool Copies(bool Escaped, std::pmr::memory_resource *Resource)
+    {
+        if constexpr (requires { requires TString::Copies; })
+            return Escaped;
+        else if constexpr (!std::is_trivially_destructible_v<TString>)
+            return true;
+        else
+            return Escaped && Resource != std::pmr::new_delete_resource();
+    }
+
+    // Same for a string of any kind, nullopt for invalid ones
+
+    template <typename TString>
+    std::optional<TString> Make(std::string_view Raw, Kind Type, std::pmr::memory_resource *Resource)
+    {
+        if (Type == Kind::Invalid)
+            return std::nullopt;
+
+        return Make<TString>(Raw, Type == Kind::Escaped, Resource);
+    }
+
+    constexpr bool Special(char c)
+    {
+        return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+    }
+
+    // Size of Text once escaped, quotes excluded
+
+    inline std::size_t Measure(std::string_view Text)
+    {
+        std::size_t Size = Text.size();
+
+        for (char c : Text)
+        {
+            if (Special(c))
+                Size += c == '"' || c == '\\' || c == '\b' || c == '\f' || c == '\n' || c == '\r' || c == '\t' ? 1 : 5;
+        }
+
+        return Size;
+    }
+
+    // Hands Text to Put(std::string_view) escaped, quotes excluded, in as few pieces as possible
+
+    template <typename TPut>
+    inline void Encode(std::string_view Text, TPut &&Put)
+    {
+        std::size_t Written = 0;
+
+        auto Replace = [&](std::size_t i)
+        {
+            if (i > Written)
+                Put(Text.substr(Written, i - Written));
+
+            char c = Text[i];
+
+            switch (c)
+            {
+            case '"':
+                Put("\\\"");
+                break;
+            case '\\':
+                Put("\\\\");
+                break;
+            case '\b':
+                Put("\\b");
+                break;
+            case '\f':
+                Put("\\f");
+                break;
+            case '\n':
+                Put("\\n");
+                break;
+            case '\r':
+                Put("\\r");
+                break;
+            case '\t':
+                Put("\\t");
+                break;
+            default:
+            {
+                constexpr char Digits[] = "0123456789abcdef";
+                char Sequence[6] = {'\\', 'u', '0', '0', Digits[c >> 4], Digits[c & 0xF]};
+
+                Put(std::string_view{Sequence, 6});
+            }
+            }
+
+            Written = i + 1;
+        };
+
+        // Most strings need no escaping at all, which is found without locating anything
+
+        if (auto Found = Summarise(Text); !Found.Quote && !Found.Backslash && !Found.Control)
+        {
+            Put(Text);
+            return;
+        }
+
+        Blocks(Text, [&](Bytes Masks, std::size_t Offset)
+               {
+                   for (std::uint32_t Found = Masks.Quote | Masks.Backslash | Masks.Control; Found; Found &= Found - 1)
+                       Replace(Offset + std::countr_zero(Found));
+
+                   return true; });
+
+        if (Written < Text.size())
+            Put(Text.substr(Written));
+    }
+}
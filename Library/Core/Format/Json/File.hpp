@@ -0,0 +1,217 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <fstream>
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+#include <memory_resource>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define CORE_JSON_MMAP 1
+#endif
+
+#include "Arena.hpp"
+
+// Parsing straight out of files. The file is mapped read only and the documents keep their
+// string views pointing into the mapping, so instantiations with std::string_view keys and
+// values are zero copy and stay valid for as long as the handle owning both lives. Without
+// mmap the file is read into a buffer owned the same way.
+
+namespace Core
+{
+    class Mapping
+    {
+    public:
+        Mapping() = default;
+
+        explicit Mapping(std::filesystem::path const &File)
+        {
+#ifdef CORE_JSON_MMAP
+            int Descriptor = ::open(File.c_str(), O_RDONLY | O_CLOEXEC);
+
+            if (Descriptor < 0)
+                throw std::system_error(errno, std::generic_category(), File.string());
+
+            struct stat Status;
+
+            if (::fstat(Descriptor, &Status) < 0)
+            {
+                int Error = errno;
+                ::close(Descriptor);
+
+                throw std::system_error(Error, std::generic_category(), File.string());
+            }
+
+            Size = static_cast<std::size_t>(Status.st_size);
+
+            // Empty files can't be mapped, they are left as an empty view
+
+            if (Size)
+            {
+                void *Address = ::mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, Descriptor, 0);
+
+                if (Address == MAP_FAILED)
+                {
+                    int Error = errno;
+                    ::close(Descriptor);
+
+                    throw std::system_error(Error, std::generic_category(), File.string());
+                }
+
+                Data = static_cast<char const *>(Address);
+
+                // The parser reads the whole file front to back once, have it read ahead
+
+                ::madvise(Address, Size, MADV_SEQUENTIAL);
+                ::madvise(Address, Size, MADV_WILLNEED);
+            }
+
+            ::close(Descriptor);
+#else
+            std::ifstream Stream{File, std::ios::binary | std::ios::ate};
+
+            if (!Stream)
+                throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory), File.string());
+
+            Size = static_cast<std::size_t>(Stream.tellg());
+            Buffer = std::make_unique_for_overwrite<char[]>(Size);
+
+            Stream.seekg(0);
+            Stream.read(Buffer.get(), Size);
+
+            Data = Buffer.get();
+#endif
+        }
+
+        Mapping(Mapping &&Other) noexcept
+            : Data(std::exchange(Other.Data, nullptr)), Size(std::exchange(Other.Size, 0))
+#ifndef CORE_JSON_MMAP
+              ,
+              Buffer(std::move(Other.Buffer))
+#endif
+        {
+        }
+
+        Mapping &operator=(Mapping &&Other) noexcept
+        {
+            if (this != &Other)
+            {
+                Release();
+
+                Data = std::exchange(Other.Data, nullptr);
+                Size = std::exchange(Other.Size, 0);
+#ifndef CORE_JSON_MMAP
+                Buffer = std::move(Other.Buffer);
+#endif
+            }
+
+            return *this;
+        }
+
+        Mapping(Mapping const &) = delete;
+        Mapping &operator=(Mapping const &) = delete;
+
+        ~Mapping()
+        {
+            Release();
+        }
+
+        std::string_view View() const
+        {
+            return {Data, Size};
+        }
+
+    private:
+        char const *Data = nullptr;
+        std::size_t Size = 0;
+
+#ifndef CORE_JSON_MMAP
+        std::unique_ptr<char[]> Buffer;
+#endif
+
+        void Release()
+        {
+#ifdef CORE_JSON_MMAP
+            if (Data)
+                ::munmap(const_cast<char *>(Data), Size);
+#endif
+
+            Data = nullptr;
+            Size = 0;
+        }
+    };
+
+    // Owns a file mapping along with the document parsed out of it, TDocument being any type
+    // with a static From(std::string_view, ...) such as the Json instantiations or Tape. The
+    // mapping doesn't move when the handle does, so the views of the document survive it.
+    // Without arguments, documents taking a memory resource are given an arena owned by the
+    // handle, which holds the decoded strings views of strings with escapes point to.
+
+    template <typename TDocument>
+    class Mapped
+    {
+    public:
+        template <typename... TArgs>
+        explicit Mapped(std::filesystem::path const &File, TArgs &&...Args)
+            : Source(File), Root(Parse(std::forward<TArgs>(Args)...))
+        {
+        }
+
+        TDocument &operator*()
+        {
+            return Root;
+        }
+
+        TDocument const &operator*() const
+        {
+            return Root;
+        }
+
+        TDocument *operator->()
+        {
+            return &Root;
+        }
+
+        TDocument const *operator->() const
+        {
+            return &Root;
+        }
+
+        std::string_view GetSource() const
+        {
+            return Source.View();
+        }
+
+    private:
+        Mapping Source;
+        std::unique_ptr<Arena> Strings;
+        TDocument Root;
+
+        template <typename... TArgs>
+        TDocument Parse(TArgs &&...Args)
+        {
+            if constexpr (sizeof...(TArgs) == 0 && requires { TDocument::From(std::string_view{}, std::pmr::get_default_resource()); })
+            {
+                Strings = std::make_unique<Arena>();
+
+                return TDocument::From(Source.View(), Strings.get());
+            }
+            else
+            {
+                return TDocument::From(Source.View(), std::forward<TArgs>(Args)...);
+            }
+        }
+    };
+
+    template <typename TDocument, typename... TArgs>
+    Mapped<TDocument> FromFile(std::filesystem::path const &File, TArgs &&...Args)
+    {
+        return Mapped<TDocument>{File, std::forward<TArgs>(Args)...};
+    }
+}
@@ -0,0 +1,355 @@
+#pragma once
+
+#include <bit>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+// Alternative object storages for Core::Json. They keep the members in one contiguous
+// vector so small objects are iterated without pointer chasing, and only implement the
+// part of the std::map interface the Json type relies on.
+
+namespace Core
+{
+    // Keeps the members in insertion order and looks them up linearly, best for small objects
+
+    template <typename TKey, typename TValue>
+    class FlatMap
+    {
+    public:
+        using key_type = TKey;
+        using mapped_type = TValue;
+        using value_type = std::pair<TKey, TValue>;
+        using iterator = typename std::vector<value_type>::iterator;
+        using const_iterator = typename std::vector<value_type>::const_iterator;
+
+        FlatMap() = default;
+
+        iterator find(TKey const &Key)
+        {
+            return std::find_if(Entries.begin(), Entries.end(), [&](auto const &Entry)
+                                { return Entry.first == Key; });
+        }
+
+        const_iterator find(TKey const &Key) const
+        {
+            return std::find_if(Entries.begin(), Entries.end(), [&](auto const &Entry)
+                                { return Entry.first == Key; });
+        }
+
+        bool contains(TKey const &Key) const
+        {
+            return find(Key) != end();
+        }
+
+        std::pair<iterator, bool> insert(value_type Entry)
+        {
+            if (auto It = find(Entry.first); It != end())
+                return {It, false};
+
+            Entries.push_back(std::move(Entry));
+
+            return {std::prev(Entries.end()), true};
+        }
+
+        template <typename... TArgs>
+        std::pair<iterator, bool> emplace(TArgs &&...Args)
+        {
+            return insert(value_type(std::forward<TArgs>(Args)...));
+        }
+
+        TValue &operator[](TKey const &Key)
+        {
+            if (auto It = find(Key); It != end())
+                return It->second;
+
+            return insert(value_type{Key, TValue{}}).first->second;
+        }
+
+        void reserve(std::size_t Count)
+        {
+            Entries.reserve(Count);
+        }
+
+        void clear()
+        {
+            Entries.clear();
+        }
+
+        std::size_t size() const
+        {
+            return Entries.size();
+        }
+
+        bool empty() const
+        {
+            return Entries.empty();
+        }
+
+        iterator begin() { return Entries.begin(); }
+        iterator end() { return Entries.end(); }
+        const_iterator begin() const { return Entries.begin(); }
+        const_iterator end() const { return Entries.end(); }
+
+        // Objects are equal regardless of their member order
+
+        bool operator==(FlatMap const &Other) const
+        {
+            if (size() != Other.size())
+                return false;
+
+            return std::all_of(begin(), end(), [&](auto const &Entry)
+                               {
+                                   auto It = Other.find(Entry.first);
+                                   return It != Other.end() && It->second == Entry.second; });
+        }
+
+    private:
+        std::vector<value_type> Entries;
+    };
+
+    // Keeps the members sorted by key and looks them up with a binary search
+
+    template <typename TKey, typename TValue>
+    class SortedMap
+    {
+    public:
+        using key_type = TKey;
+        using mapped_type = TValue;
+        using value_type = std::pair<TKey, TValue>;
+        using iterator = typename std::vector<value_type>::iterator;
+        using const_iterator = typename std::vector<value_type>::const_iterator;
+
+        SortedMap() = default;
+
+        iterator find(TKey const &Key)
+        {
+            auto It = LowerBound(Key);
+
+            return It != end() && It->first == Key ? It : end();
+        }
+
+        const_iterator find(TKey const &Key) const
+        {
+            return const_cast<SortedMap *>(this)->find(Key);
+        }
+
+        bool contains(TKey const &Key) const
+        {
+            return find(Key) != end();
+        }
+
+        std::pair<iterator, bool> insert(value_type Entry)
+        {
+            auto It = LowerBound(Entry.first);
+
+            if (It != end() && It->first == Entry.first)
+                return {It, false};
+
+            return {Entries.insert(It, std::move(Entry)), true};
+        }
+
+        template <typename... TArgs>
+        std::pair<iterator, bool> emplace(TArgs &&...Args)
+        {
+            return insert(value_type(std::forward<TArgs>(Args)...));
+        }
+
+        TValue &operator[](TKey const &Key)
+        {
+            if (auto It = find(Key); It != end())
+                return It->second;
+
+            return insert(value_type{Key, TValue{}}).first->second;
+        }
+
+        void reserve(std::size_t Count)
+        {
+            Entries.reserve(Count);
+        }
+
+        void clear()
+        {
+            Entries.clear();
+        }
+
+        std::size_t size() const
+        {
+            return Entries.size();
+        }
+
+        bool empty() const
+        {
+            return Entries.empty();
+        }
+
+        iterator begin() { return Entries.begin(); }
+        iterator end() { return Entries.end(); }
+        const_iterator begin() const { return Entries.begin(); }
+        const_iterator end() const { return Entries.end(); }
+
+        bool operator==(SortedMap const &Other) const
+        {
+            return Entries == Other.Entries;
+        }
+
+    private:
+        std::vector<value_type> Entries;
+
+        iterator LowerBound(TKey const &Key)
+        {
+            return std::lower_bound(Entries.begin(), Entries.end(), Key, [](auto const &Entry, TKey const &Key)
+                                    { return Entry.first < Key; });
+        }
+    };
+
+    // Open addressing with linear probing over a table of indices into an insertion ordered
+    // vector of members, so iteration stays sequential while lookups stay O(1) for wide objects
+
+    template <typename TKey, typename TValue, typename THash = std::hash<TKey>>
+    class HashMap
+    {
+    public:
+        using key_type = TKey;
+        using mapped_type = TValue;
+        using value_type = std::pair<TKey, TValue>;
+        using iterator = typename std::vector<value_type>::iterator;
+        using const_iterator = typename std::vector<value_type>::const_iterator;
+
+        HashMap() = default;
+
+        iterator find(TKey const &Key)
+        {
+            if (Slots.empty())
+                return end();
+
+            std::size_t Hash = THash{}(Key);
+            std::size_t Mask = Slots.size() - 1;
+
+            for (std::size_t i = Hash & Mask; Slots[i].Index; i = (i + 1) & Mask)
+            {
+                if (Slots[i].Hash == std::uint32_t(Hash) && Entries[Slots[i].Index - 1].first == Key)
+                    return Entries.begin() + (Slots[i].Index - 1);
+            }
+
+            return end();
+        }
+
+        const_iterator find(TKey const &Key) const
+        {
+            return const_cast<HashMap *>(this)->find(Key);
+        }
+
+        bool contains(TKey const &Key) const
+        {
+            return find(Key) != end();
+        }
+
+        std::pair<iterator, bool> insert(value_type Entry)
+        {
+            if ((Entries.size() + 1) * 2 > Slots.size())
+                Rehash(std::max<std::size_t>(Slots.size() * 2, 8));
+
+            std::size_t Hash = THash{}(Entry.first);
+            std::size_t Mask = Slots.size() - 1;
+            std::size_t i = Hash & Mask;
+
+            for (; Slots[i].Index; i = (i + 1) & Mask)
+            {
+                if (Slots[i].Hash == std::uint32_t(Hash) && Entries[Slots[i].Index - 1].first == Entry.first)
+                    return {Entries.begin() + (Slots[i].Index - 1), false};
+            }
+
+            Entries.push_back(std::move(Entry));
+            Slots[i] = {static_cast<std::uint32_t>(Entries.size()), std::uint32_t(Hash)};
+
+            return {std::prev(Entries.end()), true};
+        }
+
+        template <typename... TArgs>
+        std::pair<iterator, bool> emplace(TArgs &&...Args)
+        {
+            return insert(value_type(std::forward<TArgs>(Args)...));
+        }
+
+        TValue &operator[](TKey const &Key)
+        {
+            if (auto It = find(Key); It != end())
+                return It->second;
+
+            return insert(value_type{Key, TValue{}}).first->second;
+        }
+
+        void reserve(std::size_t Count)
+        {
+            Entries.reserve(Count);
+
+            if (Count * 2 > Slots.size())
+                Rehash(std::bit_ceil(Count * 2));
+        }
+
+        void clear()
+        {
+            Entries.clear();
+            Slots.clear();
+        }
+
+        std::size_t size() const
+        {
+            return Entries.size();
+        }
+
+        bool empty() const
+        {
+            return Entries.empty();
+        }
+
+        iterator begin() { return Entries.begin(); }
+        iterator end() { return Entries.end(); }
+        const_iterator begin() const { return Entries.begin(); }
+        const_iterator end() const { return Entries.end(); }
+
+        bool operator==(HashMap const &Other) const
+        {
+            if (size() != Other.size())
+                return false;
+
+            return std::all_of(begin(), end(), [&](auto const &Entry)
+                               {
+                                   auto It = Other.find(Entry.first);
+                                   return It != Other.end() && It->second == Entry.second; });
+        }
+
+    private:
+        // Index is one based so a zeroed slot is empty, Hash keeps the low bits to skip most key compares
+
+        struct Slot
+        {
+            std::uint32_t Index;
+            std::uint32_t Hash;
+        };
+
+        std::vector<value_type> Entries;
+        std::vector<Slot> Slots;
+
+        void Rehash(std::size_t Count)
+        {
+            Slots.assign(Count, Slot{0, 0});
+
+            std::size_t Mask = Count - 1;
+
+            for (std::size_t Index = 0; Index < Entries.size(); ++Index)
+            {
+                std::size_t Hash = THash{}(Entries[Index].first);
+                std::size_t i = Hash & Mask;
+
+                while (Slots[i].Index)
+                    i = (i + 1) & Mask;
+
+                Slots[i] = {static_cast<std::uint32_t>(Index + 1), std::uint32_t(Hash)};
+            }
+        }
+    };
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <vector>
+#include <cstring>
+#include <type_traits>
+#include <string_view>
+
+#include "Parallel.hpp"
+#include "Structural.hpp"
+
+// Newline delimited Json : one document per line. JSON strings cannot hold a raw new line so
+// the buffer can be cut on '\n' without looking at its content, which lets the batch be split
+// into chunks parsed independently on several threads.
+
+namespace Core::NdJson
+{
+    // Calls Callback(Record) for every line holding something other than white space
+
+    template <typename TCallback>
+    void Records(std::string_view Buffer, TCallback &&Callback)
+    {
+        while (!Buffer.empty())
+        {
+            auto End = static_cast<char const *>(std::memchr(Buffer.data(), '\n', Buffer.size()));
+            std::size_t Length = End ? End - Buffer.data() : Buffer.size();
+
+            auto Line = Buffer.substr(0, Length);
+
+            for (char c : Line)
+            {
+                if (!Structural::IsWhiteSpace(c))
+                {
+                    Callback(Line);
+                    break;
+                }
+            }
+
+            Buffer.remove_prefix(std::min(Length + 1, Buffer.size()));
+        }
+    }
+
+    // Cuts the buffer in about Count pieces, each ending right after a new line
+
+    inline std::vector<std::string_view> Chunks(std::string_view Buffer, std::size_t Count)
+    {
+        std::vector<std::string_view> Result;
+
+        std::size_t Size = std::max<std::size_t>(Buffer.size() / std::max<std::size_t>(Count, 1), 1);
+
+        while (!Buffer.empty())
+        {
+            std::size_t Length = Buffer.size();
+
+            if (Size < Buffer.size())
+            {
+                auto End = static_cast<char const *>(std::memchr(Buffer.data() + Size, '\n', Buffer.size() - Size));
+
+                if (End)
+                    Length = End - Buffer.data() + 1;
+            }
+
+            Result.push_back(Buffer.substr(0, Length));
+            Buffer.remove_prefix(Length);
+        }
+
+        return Result;
+    }
+
+    // Chunks of a batch along with the index of the first record of each of them
+
+    struct Batch
+    {
+        std::vector<std::string_view> Pieces;
+        std::vector<std::size_t> First;
+
+        Batch(std::string_view Buffer, std::size_t Threads)
+            // A few chunks per thread so a thread stuck on a slow chunk doesn't hold the others back
+            : Pieces(Chunks(Buffer, Threads * 8)), First(Pieces.size() + 1, 0)
+        {
+            Parallel::For(
+                Pieces.size(), [&](std::size_t i)
+                { Records(Pieces[i], [&](std::string_view)
+                          { ++First[i + 1]; }); },
+                Threads);
+
+            for (std::size_t i = 1; i < First.size(); ++i)
+                First[i] += First[i - 1];
+        }
+
+        std::size_t Size() const
+        {
+            return First.back();
+        }
+
+        // Parses the records of every chunk and calls Callback(Document, Index)
+
+        template <typename TJson, typename TCallback>
+        void Parse(TCallback &&Callback, std::size_t Threads) const
+        {
+            Parallel::For(
+                Pieces.size(), [&](std::size_t i)
+                {
+                    std::size_t Index = First[i];
+
+                    Records(Pieces[i], [&](std::string_view Record)
+                            { Callback(TJson::From(Record), Index++); }); },
+                Threads);
+        }
+    };
+
+    // Parses every record with TJson::From on up to Threads threads and calls
+    // Callback(Document, Index) where Index is the position of the record in the input.
+    // The callback runs on the worker threads, in no particular order.
+
+    template <typename TJson, typename TCallback>
+        requires(std::is_invocable_v<TCallback, TJson &&, std::size_t>)
+    void Parse(std::string_view Buffer, TCallback &&Callback, std::size_t Threads = Parallel::Workers())
+    {
+        Batch{Buffer, Threads}.template Parse<TJson>(Callback, Threads);
+    }
+
+    // Parses every record and returns the documents in input order
+
+    template <typename TJson>
+    std::vector<TJson> Parse(std::string_view Buffer, std::size_t Threads = Parallel::Workers())
+    {
+        Batch Work{Buffer, Threads};
+
+        std::vector<TJson> Result(Work.Size());
+
+        Work.template Parse<TJson>([&](TJson &&Document, std::size_t Index)
+                                      { Result[Index] = std::move(Document); },
+                                      Threads);
+
+        return Result;
+    }
+}
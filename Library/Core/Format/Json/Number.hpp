@@ -0,0 +1,234 @@
+#pragma once
+
+#include <cstdint>
+#include <charconv>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+// Numbers are scanned once : the grammar of RFC 8259 is checked while the digits of integers
+// are accumulated, so integers never go through a conversion and floats only through one.
+//
+// Core::Number keeps a number as its text instead, converting it on As<>() only. Listing it
+// among the types of a strategy makes the parsers store every number that way, which suits
+// documents passed through without most of their numbers being read, and keeps big integers
+// and floats exactly as written. The text is a view into the input, which has to outlive it.
+
+namespace Core
+{
+    class Number
+    {
+    public:
+        enum class Kind : std::uint8_t
+        {
+            Integer,
+            Float,
+            // Integers outside of the range of std::int64_t
+            Big,
+            // Floats too large for a double, the ones too small for it round to zero
+            OutOfRange,
+            Invalid
+        };
+
+        // Classifies Token, leaving its value in Integer for Kind::Integer and, when asked for,
+        // in Double for Kind::Float and Kind::Big. Out of range floats are only found then.
+
+        static constexpr Kind Scan(std::string_view Token, std::int64_t &Integer, double *Double = nullptr)
+        {
+            // Powers of ten that are exact doubles
+
+            constexpr double Exact[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+            std::size_t i = 0;
+            bool Negative = i < Token.size() && Token[i] == '-';
+
+            i += Negative;
+
+            auto Digit = [&](std::size_t j)
+            {
+                return j < Token.size() && Token[j] >= '0' && Token[j] <= '9';
+            };
+
+            if (!Digit(i))
+                return Kind::Invalid;
+
+            // Every digit goes into Mantissa until it would overflow, from then on the number
+            // is left to std::from_chars
+
+            std::uint64_t Mantissa = 0;
+            std::int64_t Exponent = 0;
+            bool Overflow = false;
+            bool Float = false;
+
+            auto Accumulate = [&](char c)
+            {
+                if (Mantissa > (UINT64_MAX - 9) / 10)
+                    Overflow = true;
+                else
+                    Mantissa = Mantissa * 10 + (c - '0');
+
+                return !Overflow;
+            };
+
+            if (Token[i] == '0')
+            {
+                ++i;
+            }
+            else
+            {
+                for (; Digit(i); ++i)
+                    Exponent += !Accumulate(Token[i]);
+            }
+
+            if (i < Token.size() && Token[i] == '.')
+            {
+                if (!Digit(++i))
+                    return Kind::Invalid;
+
+                for (; Digit(i); ++i)
+                    Exponent -= Accumulate(Token[i]);
+
+                Float = true;
+            }
+
+            if (i < Token.size() && (Token[i] == 'e' || Token[i] == 'E'))
+            {
+                bool Minus = ++i < Token.size() && Token[i] == '-';
+
+                if (i < Token.size() && (Token[i] == '+' || Token[i] == '-'))
+                    ++i;
+
+                if (!Digit(i))
+                    return Kind::Invalid;
+
+                std::int64_t Written = 0;
+
+                for (; Digit(i); ++i)
+                    Written = Written < 100000 ? Written * 10 + (Token[i] - '0') : Written;
+
+                Exponent += Minus ? -Written : Written;
+                Float = true;
+            }
+
+            if (i != Token.size())
+                return Kind::Invalid;
+
+            if (!Float && !Overflow && Mantissa <= std::uint64_t(INT64_MAX) + Negative)
+            {
+                Integer = Negative ? std::int64_t(0 - Mantissa) : std::int64_t(Mantissa);
+
+                return Kind::Integer;
+            }
+
+            if (Double)
+            {
+                // Both operands being exact the result is rounded once, so correctly
+
+                if (!Overflow && Mantissa <= (std::uint64_t{1} << 53) && Exponent >= -22 && Exponent <= 22)
+                {
+                    double Value = static_cast<double>(Mantissa);
+
+                    Value = Exponent < 0 ? Value / Exact[-Exponent] : Value * Exact[Exponent];
+                    *Double = Negative ? -Value : Value;
+                }
+                else if (!std::is_constant_evaluated())
+                {
+                    auto [Pointer, Error] = std::from_chars(Token.data(), Token.data() + Token.size(), *Double);
+
+                    if (Error == std::errc::result_out_of_range)
+                    {
+                        // The number being below Mantissa's number of digits plus Exponent
+                        // powers of ten, it is too small rather than too large when that's
+                        // at most zero
+
+                        std::int64_t Magnitude = Exponent;
+
+                        for (auto Left = Mantissa; Left; Left /= 10)
+                            ++Magnitude;
+
+                        if (Magnitude > 0)
+                            return Kind::OutOfRange;
+
+                        *Double = Negative ? -0.0 : 0.0;
+                    }
+                }
+            }
+
+            return Float ? Kind::Float : Kind::Big;
+        }
+
+        constexpr Number() = default;
+
+        constexpr Number(std::string_view Text, Kind Type)
+            : Text(Text), Type(Type)
+        {
+        }
+
+        constexpr std::string_view GetRaw() const
+        {
+            return Text;
+        }
+
+        constexpr Kind GetKind() const
+        {
+            return Type;
+        }
+
+        // Converts the number, throwing std::out_of_range when it doesn't fit Target and
+        // std::invalid_argument when an integer is asked for a float. Floats too small for
+        // Target round to zero.
+
+        template <typename Target>
+        Target As() const
+        {
+            static_assert(std::is_arithmetic_v<Target> && !std::is_same_v<Target, bool>, "Numbers convert to arithmetic types");
+
+            if constexpr (std::is_integral_v<Target>)
+            {
+                if (Type == Kind::Float || Type == Kind::OutOfRange)
+                    throw std::invalid_argument("Number is not an integer");
+            }
+
+            Target Result{};
+
+            auto [Pointer, Error] = std::from_chars(Text.data(), Text.data() + Text.size(), Result);
+
+            if constexpr (std::is_floating_point_v<Target>)
+            {
+                // Too small rather than too large, rounds to zero or a subnormal
+
+                std::int64_t Integer;
+                double Double;
+
+                if (Error == std::errc::result_out_of_range && Scan(Text, Integer, &Double) != Kind::OutOfRange && Double > -1 && Double < 1)
+                    return static_cast<Target>(Double);
+            }
+
+            if (Error == std::errc::result_out_of_range)
+                throw std::out_of_range("Number does not fit the type");
+
+            if (Error != std::errc() || Pointer != Text.data() + Text.size())
+                throw std::invalid_argument("Number is malformed");
+
+            return Result;
+        }
+
+        constexpr bool operator==(Number const &Other) const
+        {
+            return Text == Other.Text;
+        }
+
+        template <typename TSerializer>
+        friend TSerializer &operator<<(TSerializer &os, Number const &Value)
+        {
+            os << Value.Text;
+
+            return os;
+        }
+
+    private:
+        std::string_view Text;
+        Kind Type = Kind::Integer;
+    };
+}
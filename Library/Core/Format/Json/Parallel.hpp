@@ -0,0 +1,61 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <exception>
+
+namespace Core::Parallel
+{
+    inline std::size_t Workers()
+    {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Runs Function(i) for every i in [0, Count) on up to Threads threads, the calling one
+    // included. Indices are handed out one at a time so faster workers take over the rest of
+    // the range. The first exception thrown by a task is rethrown once all workers are done.
+
+    template <typename TFunction>
+    void For(std::size_t Count, TFunction &&Function, std::size_t Threads = Workers())
+    {
+        std::atomic<std::size_t> Next{0};
+        std::exception_ptr Failure;
+        std::mutex Lock;
+
+        auto Work = [&]
+        {
+            for (std::size_t i; (i = Next.fetch_add(1, std::memory_order_relaxed)) < Count;)
+            {
+                try
+                {
+                    Function(i);
+                }
+                catch (...)
+                {
+                    std::lock_guard Guard{Lock};
+
+                    if (!Failure)
+                        Failure = std::current_exception();
+
+                    Next.store(Count, std::memory_order_relaxed);
+                }
+            }
+        };
+
+        {
+            std::vector<std::jthread> Pool;
+
+            for (std::size_t t = 1; t < std::min(Threads, Count); ++t)
+                Pool.emplace_back(Work);
+
+            Work();
+        }
+
+        if (Failure)
+            std::rethrow_exception(Failure);
+    }
+}
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+#include "Sax.hpp"
+#include "Escape.hpp"
+#include "Structural.hpp"
+
+// Json Pointer (RFC 6901) queries run over the structural index. A path is split and unescaped
+// once, running it walks the input and skips every member or item not on the path by bracket
+// matching alone, nothing is parsed or allocated besides the index. Matches are handed out as
+// the raw text of the value, quotes included for strings, which can then be given to any of
+// the parsers. A segment made of a single '*' matches every member or item. Without such a
+// segment a path designates one value and the walk stops as soon as it is found.
+
+namespace Core
+{
+    class Path
+    {
+    public:
+        // "" is the whole document, otherwise every segment starts with '/'
+
+        explicit Path(std::string_view Pointer)
+        {
+            if (!Pointer.empty() && Pointer.front() != '/')
+                throw std::invalid_argument("Json pointer has to start with '/'");
+
+            while (!Pointer.empty())
+            {
+                Pointer.remove_prefix(1);
+
+                auto End = Pointer.find('/');
+                auto Token = Pointer.substr(0, End);
+
+                Segments.push_back(Compile(Token));
+                Single &= !Segments.back().Wildcard;
+
+                Pointer.remove_prefix(End == std::string_view::npos ? Pointer.size() : End);
+            }
+        }
+
+        // Calls Callback(Raw) for every match within the value the cursor points at and leaves
+        // the cursor after it. A callback returning false stops the walk, in which case or once
+        // the single value of a path without wildcards is found this returns false and the
+        // cursor is left where the walk stopped.
+
+        template <typename TCallback>
+        bool Each(Structural::Cursor &Cursor, TCallback &&Callback) const
+        {
+            return Match(Cursor, 0, Callback);
+        }
+
+        // Runs over an index built beforehand, so several paths can share it
+
+        template <typename TCallback>
+        void Each(Structural::Index const &Positions, TCallback &&Callback) const
+        {
+            Structural::Cursor Cursor{Positions};
+
+            Match(Cursor, 0, Callback);
+        }
+
+        template <typename TCallback>
+        void Each(std::string_view Input, TCallback &&Callback) const
+        {
+            Each(Structural::Index{Input}, Callback);
+        }
+
+        std::vector<std::string_view> All(std::string_view Input) const
+        {
+            std::vector<std::string_view> Result;
+
+            Each(Input, [&](std::string_view Raw)
+                 { Result.push_back(Raw); });
+
+            return Result;
+        }
+
+        std::optional<std::string_view> First(std::string_view Input) const
+        {
+            std::optional<std::string_view> Result;
+
+            Each(Input, [&](std::string_view Raw)
+                 {
+                     Result = Raw;
+                     return false; });
+
+            return Result;
+        }
+
+        std::size_t Size() const
+        {
+            return Segments.size();
+        }
+
+    private:
+        constexpr static std::size_t NoIndex = std::size_t(-1);
+
+        struct Segment
+        {
+            std::string Key;
+            std::size_t Index = NoIndex;
+            bool Wildcard = false;
+        };
+
+        std::vector<Segment> Segments;
+        bool Single = true;
+
+        static Segment Compile(std::string_view Token)
+        {
+            Segment Result;
+
+            Result.Wildcard = Token == "*";
+
+            for (std::size_t i = 0; i < Token.size(); ++i)
+            {
+                if (Token[i] != '~')
+                {
+                    Result.Key += Token[i];
+                    continue;
+                }
+
+                if (++i == Token.size() || (Token[i] != '0' && Token[i] != '1'))
+                    throw std::invalid_argument("Invalid escape in json pointer");
+
+                Result.Key += Token[i] == '0' ? '~' : '/';
+            }
+
+            // Array indices are written without leading zeros
+
+            if (!Token.empty() && Token.size() < 19 && Token.find_first_not_of("0123456789") == std::string_view::npos && (Token == "0" || Token[0] != '0'))
+                Sax::Number(Token, Result.Index);
+
+            return Result;
+        }
+
+        // Compares the raw key of a member to the unescaped key of a segment
+
+        static bool Same(std::string_view Raw, std::string_view Key)
+        {
+            if (Raw.find('\\') == std::string_view::npos)
+                return Raw == Key;
+
+            std::string Decoded(Raw.size(), '\0');
+
+            auto Size = Escape::Decode(Raw, Decoded.data());
+
+            return Size != Escape::Invalid && std::string_view{Decoded.data(), Size} == Key;
+        }
+
+        template <typename TCallback>
+        bool Match(Structural::Cursor &Cursor, std::size_t Depth, TCallback &Callback) const
+        {
+            if (Depth == Segments.size())
+            {
+                auto Raw = Cursor.Raw();
+
+                return Sax::Emit([&]
+                                 { return Callback(Raw); }) &&
+                       !Single;
+            }
+
+            auto const &Next = Segments[Depth];
+
+            if (char Token = Cursor.Peek(); Token == '{')
+            {
+                Cursor.Next();
+
+                while (Cursor.Peek() == '"')
+                {
+                    auto Key = Cursor.String();
+
+                    if (Cursor.Peek() != ':')
+                        break;
+
+                    Cursor.Next();
+
+                    if (Next.Wildcard || Same(Key, Next.Key))
+                    {
+                        if (!Match(Cursor, Depth + 1, Callback))
+                            return false;
+                    }
+                    else
+                    {
+                        Cursor.Raw();
+                    }
+
+                    if (Cursor.Peek() != ',')
+                        break;
+
+                    Cursor.Next();
+                }
+
+                if (Cursor.Peek() == '}')
+                    Cursor.Next();
+            }
+            else if (Token == '[')
+            {
+                Cursor.Next();
+
+                for (std::size_t i = 0; Cursor.Peek() != ']' && !Cursor.End(); ++i)
+                {
+                    if (Next.Wildcard || i == Next.Index)
+                    {
+                        if (!Match(Cursor, Depth + 1, Callback))
+                            return false;
+                    }
+                    else
+                    {
+                        Cursor.Raw();
+                    }
+
+                    if (Cursor.Peek() != ',')
+                        break;
+
+                    Cursor.Next();
+                }
+
+                if (Cursor.Peek() == ']')
+                    Cursor.Next();
+            }
+            else
+            {
+                Cursor.Raw();
+            }
+
+            return true;
+        }
+    };
+}
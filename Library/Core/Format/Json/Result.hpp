@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <optional>
+
+// Outcome of the parses that report their errors rather than throw or keep what they got
+// before the error, see TryFrom. Offsets are in bytes from the start of the input and point
+// at the token the error was found on, or at the end of the input when it ran out.
+
+namespace Core
+{
+    enum class Error : std::uint8_t
+    {
+        None,
+        // Missing, misplaced or unexpected structural character, including trailing commas
+        Syntax,
+        // Containers nested deeper than Sax::MaxDepth
+        Depth,
+        // Control characters, malformed escapes or invalid UTF-8 in a string or key
+        String,
+        // Token that is neither a literal nor a number, or a float out of the range of double
+        Number,
+        // Anything but white space after the value
+        Trailing,
+        // The handler stopped the parse
+        Stopped,
+        // Valid input of a type the target can't hold, e.g. a Json whose root isn't an object
+        Type,
+        // Input or string longer than allowed, see Validate and Structural::MaxSize
+        Size
+    };
+
+    inline char const *Message(Error Code)
+    {
+        switch (Code)
+        {
+        case Error::None:
+            return "no error";
+        case Error::Syntax:
+            return "syntax error";
+        case Error::Depth:
+            return "nesting too deep";
+        case Error::String:
+            return "invalid string";
+        case Error::Number:
+            return "invalid literal or number";
+        case Error::Trailing:
+            return "trailing characters";
+        case Error::Stopped:
+            return "stopped by the handler";
+        case Error::Type:
+            return "unexpected type";
+        case Error::Size:
+            return "too large";
+        }
+
+        return "unknown error";
+    }
+
+    struct Status
+    {
+        Error Code = Error::None;
+        std::size_t Offset = 0;
+
+        constexpr bool Failed() const
+        {
+            return Code != Error::None;
+        }
+    };
+
+    // Either the parsed value or the status of the failed parse
+
+    template <typename TValue>
+    class Result
+    {
+    public:
+        Result(TValue &&Value)
+            : Item(std::move(Value))
+        {
+        }
+
+        Result(Status Failure)
+            : Failure(Failure)
+        {
+        }
+
+        explicit operator bool() const
+        {
+            return Item.has_value();
+        }
+
+        TValue &operator*()
+        {
+            return *Item;
+        }
+
+        TValue const &operator*() const
+        {
+            return *Item;
+        }
+
+        TValue *operator->()
+        {
+            return &*Item;
+        }
+
+        TValue const *operator->() const
+        {
+            return &*Item;
+        }
+
+        Status GetStatus() const
+        {
+            return Failure;
+        }
+
+    private:
+        std::optional<TValue> Item;
+        Status Failure;
+    };
+}
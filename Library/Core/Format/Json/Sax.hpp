@@ -0,0 +1,443 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <charconv>
+#include <string_view>
+#include <type_traits>
+
+#include "Escape.hpp"
+#include "Number.hpp"
+#include "Result.hpp"
+#include "Structural.hpp"
+
+// Event driven parser. It walks the structural index and reports what it finds to a handler
+// without building anything itself. A handler implements the following members, each of them
+// either returning void or a bool where false stops the parse:
+//
+//     StartObject()          EndObject()
+//     StartArray()           EndArray()
+//     Key(std::string_view)  String(std::string_view)
+//     Integer(std::int64_t)  Double(double)
+//     Boolean(bool)          Null()
+//
+// and optionally Number(Core::Number) to receive numbers unconverted, see Scalar.
+//
+// Strings and keys are views into the input, except for the ones holding escapes which are
+// decoded into a buffer reused once the callback returns. Strings with control characters,
+// malformed escapes or invalid UTF-8 are errors. A handler declaring
+//
+//     constexpr static bool Decode = false;
+//
+// receives Key(std::string_view, bool) and String(std::string_view, bool) instead, always with
+// the raw content from the input and whether it holds escapes, and decodes them itself. Beside
+// that buffer the parser never allocates, nesting is tracked in a fixed bit stack which also
+// bounds the accepted depth.
+
+namespace Core::Sax
+{
+    constexpr std::size_t MaxDepth = 1024;
+
+    // Nesting of the containers being parsed, one bit per level set for objects
+
+    class Stack
+    {
+    public:
+        inline bool Push(bool Object)
+        {
+            if (Depth == MaxDepth)
+                return false;
+
+            if (Object)
+                Objects[Depth / 64] |= std::uint64_t{1} << (Depth % 64);
+            else
+                Objects[Depth / 64] &= ~(std::uint64_t{1} << (Depth % 64));
+
+            ++Depth;
+
+            return true;
+        }
+
+        inline void Pop()
+        {
+            --Depth;
+        }
+
+        inline bool InObject() const
+        {
+            return (Objects[(Depth - 1) / 64] >> ((Depth - 1) % 64)) & 1;
+        }
+
+        inline bool Empty() const
+        {
+            return !Depth;
+        }
+
+        inline std::size_t Size() const
+        {
+            return Depth;
+        }
+
+    private:
+        std::uint64_t Objects[MaxDepth / 64] = {};
+        std::size_t Depth = 0;
+    };
+
+    template <typename TCall>
+    inline bool Emit(TCall &&Call)
+    {
+        if constexpr (std::is_void_v<decltype(Call())>)
+        {
+            Call();
+            return true;
+        }
+        else
+        {
+            return Call();
+        }
+    }
+
+    template <typename TNumber>
+    inline bool Number(std::string_view Token, TNumber &Value)
+    {
+        auto [Pointer, Error] = std::from_chars(Token.data(), Token.data() + Token.size(), Value);
+
+        return Error == std::errc() && Pointer == Token.data() + Token.size();
+    }
+
+    // Reports a literal or a number, false when the token is neither. Numbers are classified
+    // in a single pass, see Core::Number::Scan. Integers outside of the range of std::int64_t
+    // are reported as doubles and floats outside of the range of double are errors, unless the
+    // handler has Number(Core::Number) which receives every number as its text instead. On
+    // failure Reason tells an invalid token from the handler stopping.
+
+    template <typename THandler>
+    inline bool Scalar(std::string_view Token, THandler &Handler, Error *Reason = nullptr)
+    {
+        auto Invalid = [&]
+        {
+            if (Reason)
+                *Reason = Error::Number;
+
+            return false;
+        };
+
+        auto Report = [&](auto &&Call)
+        {
+            if (Emit(Call))
+                return true;
+
+            if (Reason)
+                *Reason = Error::Stopped;
+
+            return false;
+        };
+
+        if (Token == "null")
+            return Report([&]
+                          { return Handler.Null(); });
+        else if (Token == "true")
+            return Report([&]
+                          { return Handler.Boolean(true); });
+        else if (Token == "false")
+            return Report([&]
+                          { return Handler.Boolean(false); });
+
+        std::int64_t Integer;
+
+        if constexpr (requires { Handler.Number(Core::Number{}); })
+        {
+            auto Type = Core::Number::Scan(Token, Integer);
+
+            if (Type == Core::Number::Kind::Invalid)
+                return Invalid();
+
+            return Report([&]
+                          { return Handler.Number(Core::Number{Token, Type}); });
+        }
+        else
+        {
+            double Double;
+
+            switch (Core::Number::Scan(Token, Integer, &Double))
+            {
+            case Core::Number::Kind::Integer:
+                return Report([&]
+                              { return Handler.Integer(Integer); });
+            case Core::Number::Kind::Float:
+            case Core::Number::Kind::Big:
+                return Report([&]
+                              { return Handler.Double(Double); });
+            default:
+                return Invalid();
+            }
+        }
+    }
+
+    template <typename THandler>
+    constexpr bool Decoding = !requires { requires !THandler::Decode; };
+
+    // Reports the raw content of a string or key, decoded into Scratch if need be. On failure
+    // Reason tells an invalid string from the handler stopping.
+
+    template <typename THandler>
+    inline bool Text(std::string_view Raw, Escape::Kind Type, bool Key, THandler &Handler, std::string &Scratch, Error *Reason = nullptr)
+    {
+        auto Invalid = [&]
+        {
+            if (Reason)
+                *Reason = Error::String;
+
+            return false;
+        };
+
+        auto Report = [&](auto &&Call)
+        {
+            if (Emit(Call))
+                return true;
+
+            if (Reason)
+                *Reason = Error::Stopped;
+
+            return false;
+        };
+
+        if (Type == Escape::Kind::Invalid)
+            return Invalid();
+
+        if constexpr (!Decoding<THandler>)
+        {
+            bool Escaped = Type == Escape::Kind::Escaped;
+
+            return Key ? Report([&]
+                                { return Handler.Key(Raw, Escaped); })
+                       : Report([&]
+                                { return Handler.String(Raw, Escaped); });
+        }
+        else
+        {
+            std::string_view View = Raw;
+
+            if (Type == Escape::Kind::Escaped)
+            {
+                Scratch.resize(Raw.size());
+
+                auto Size = Escape::Decode(Raw, Scratch.data());
+
+                if (Size == Escape::Invalid)
+                    return Invalid();
+
+                View = {Scratch.data(), Size};
+            }
+
+            return Key ? Report([&]
+                                { return Handler.Key(View); })
+                       : Report([&]
+                                { return Handler.String(View); });
+        }
+    }
+
+    // Parses the value the cursor points at and leaves the cursor right after it.
+    // Returns false on malformed input or when the handler asked to stop, with what went
+    // wrong and where in Failure. The status is spelled out as Core::Status, Sax::Status being
+    // the progress of a Stream.
+
+    template <typename THandler>
+    bool Value(Structural::Cursor &Cursor, THandler &Handler, Core::Status &Failure)
+    {
+        enum class State
+        {
+            Value,
+            Key,
+            Close
+        };
+
+        Stack Levels;
+        std::string Scratch;
+
+        State Next = State::Value;
+
+        auto Fail = [&](Error Code, std::size_t Offset)
+        {
+            Failure = {Code, Offset};
+
+            return false;
+        };
+
+        while (true)
+        {
+            std::size_t Offset = Cursor.Offset();
+
+            if (Next == State::Value)
+            {
+                char Token = Cursor.Peek();
+
+                if (Token == '{')
+                {
+                    Cursor.Next();
+
+                    if (!Emit([&]
+                              { return Handler.StartObject(); }))
+                        return Fail(Error::Stopped, Offset);
+
+                    if (Cursor.Peek() == '}')
+                    {
+                        Cursor.Next();
+
+                        if (!Emit([&]
+                                  { return Handler.EndObject(); }))
+                            return Fail(Error::Stopped, Offset);
+
+                        Next = State::Close;
+                    }
+                    else
+                    {
+                        if (!Levels.Push(true))
+                            return Fail(Error::Depth, Offset);
+
+                        Next = State::Key;
+                    }
+                }
+                else if (Token == '[')
+                {
+                    Cursor.Next();
+
+                    if (!Emit([&]
+                              { return Handler.StartArray(); }))
+                        return Fail(Error::Stopped, Offset);
+
+                    if (Cursor.Peek() == ']')
+                    {
+                        Cursor.Next();
+
+                        if (!Emit([&]
+                                  { return Handler.EndArray(); }))
+                            return Fail(Error::Stopped, Offset);
+
+                        Next = State::Close;
+                    }
+                    else
+                    {
+                        if (!Levels.Push(false))
+                            return Fail(Error::Depth, Offset);
+                    }
+                }
+                else if (Token == '"')
+                {
+                    auto Raw = Cursor.String();
+
+                    if (!Cursor.Closed(Raw))
+                        return Fail(Error::Syntax, Cursor.GetSource().size());
+
+                    if (Error Reason = Error::None; !Text(Raw, Escape::Classify(Raw, Cursor), false, Handler, Scratch, &Reason))
+                        return Fail(Reason, Offset);
+
+                    Next = State::Close;
+                }
+                else
+                {
+                    if (Cursor.End() || Structural::IsOperator(Token))
+                        return Fail(Error::Syntax, Offset);
+
+                    if (Error Reason = Error::None; !Scalar(Cursor.Scalar(), Handler, &Reason))
+                        return Fail(Reason, Offset);
+
+                    Next = State::Close;
+                }
+            }
+            else if (Next == State::Key)
+            {
+                if (Cursor.Peek() != '"')
+                    return Fail(Error::Syntax, Offset);
+
+                auto Raw = Cursor.String();
+
+                if (!Cursor.Closed(Raw))
+                    return Fail(Error::Syntax, Cursor.GetSource().size());
+
+                if (Error Reason = Error::None; !Text(Raw, Escape::Classify(Raw, Cursor), true, Handler, Scratch, &Reason))
+                    return Fail(Reason, Offset);
+
+                if (Cursor.Peek() != ':')
+                    return Fail(Error::Syntax, Cursor.Offset());
+
+                Cursor.Next();
+
+                Next = State::Value;
+            }
+            else
+            {
+                if (Levels.Empty())
+                    return true;
+
+                char Token = Cursor.Peek();
+
+                if (Token == ',')
+                {
+                    Cursor.Next();
+
+                    Next = Levels.InObject() ? State::Key : State::Value;
+                }
+                else if (Token == '}' && Levels.InObject())
+                {
+                    Cursor.Next();
+                    Levels.Pop();
+
+                    if (!Emit([&]
+                              { return Handler.EndObject(); }))
+                        return Fail(Error::Stopped, Offset);
+                }
+                else if (Token == ']' && !Levels.InObject())
+                {
+                    Cursor.Next();
+                    Levels.Pop();
+
+                    if (!Emit([&]
+                              { return Handler.EndArray(); }))
+                        return Fail(Error::Stopped, Offset);
+                }
+                else
+                {
+                    return Fail(Error::Syntax, Offset);
+                }
+            }
+        }
+    }
+
+    template <typename THandler>
+    bool Value(Structural::Cursor &Cursor, THandler &Handler)
+    {
+        Core::Status Failure;
+
+        return Value(Cursor, Handler, Failure);
+    }
+
+    // Parses a whole document, which has to consist of exactly one value
+
+    template <typename THandler>
+    bool Parse(std::string_view sv, THandler &Handler, Core::Status &Failure)
+    {
+        Structural::Index Positions{sv};
+        Structural::Cursor Cursor{Positions};
+
+        if (!Value(Cursor, Handler, Failure))
+            return false;
+
+        if (!Cursor.End())
+        {
+            Failure = {Error::Trailing, Cursor.Offset()};
+
+            return false;
+        }
+
+        return true;
+    }
+
+    template <typename THandler>
+    bool Parse(std::string_view sv, THandler &Handler)
+    {
+        Core::Status Failure;
+
+        return Parse(sv, Handler, Failure);
+    }
+}
@@ -0,0 +1,409 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+#include <variant>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <memory_resource>
+
+#include "../Json.hpp"
+
+// Strategy holding the same types as DefaultStrategy, objects and arrays being reference
+// counted and shared between copies instead of copied. Copying a value is O(1) whatever its
+// size, a copy of a Json holding these copies its own members only. Access that can modify
+// a container, i.e. operator[], the non const As, Find, TryAs and Visit, first makes the
+// container unique by copying it if it is shared. Its members are themselves shared values,
+// so editing a nested value through a chain of operator[] copies the containers on the path
+// from the root to it and nothing else, the other copies keep seeing the old tree.
+//
+// Counts are atomic and const access never modifies anything, so copies sharing a subtree
+// may be read and copied from several threads at once, and each of them modified by its own
+// thread. Containers are allocated from the resource given to From, or the default one, and
+// copied on the resource they came from. GetVariant isn't available as the variant holds
+// the containers through their counts. A moved from value is null.
+
+namespace Core
+{
+    template <typename T, typename... TO>
+    class SharedStrategy
+    {
+    public:
+        using Json = T;
+        using Array = typename T::Array;
+        using Traits = DefaultStrategy<T, TO...>;
+        using Builder = typename Traits::template Building<SharedStrategy>;
+
+        constexpr static bool Boxes = true;
+
+        SharedStrategy() = default;
+
+        // Containers are allocated on Resource
+
+        template <typename TItem>
+        SharedStrategy(TItem &&Value, std::pmr::memory_resource *Resource)
+            requires(Contains<std::decay_t<TItem>, T, Array, TO...>::value)
+        {
+            Emplace(std::forward<TItem>(Value), Resource);
+        }
+
+        // Other values are converted the way DefaultStrategy does
+
+        template <typename TItem>
+        SharedStrategy(TItem &&Value)
+            requires(!std::is_same_v<std::decay_t<TItem>, SharedStrategy>)
+        {
+            using Type = typename decltype(Traits::template Strategy<std::decay_t<TItem>>())::type;
+
+            if constexpr (std::is_same_v<std::decay_t<TItem>, Type>)
+                Emplace(std::forward<TItem>(Value), std::pmr::get_default_resource());
+            else
+                Emplace(Type(std::forward<TItem>(Value)), std::pmr::get_default_resource());
+        }
+
+        SharedStrategy(SharedStrategy const &) = default;
+
+        SharedStrategy(SharedStrategy &&Other) noexcept
+            : Item(std::move(Other.Item))
+        {
+            Other.Reset();
+        }
+
+        SharedStrategy &operator=(SharedStrategy const &) = default;
+
+        SharedStrategy &operator=(SharedStrategy &&Other) noexcept
+        {
+            if (this != &Other)
+            {
+                Item = std::move(Other.Item);
+                Other.Reset();
+            }
+
+            return *this;
+        }
+
+        template <typename TItem>
+        SharedStrategy &operator=(TItem &&Value)
+            requires(!std::is_same_v<std::decay_t<TItem>, SharedStrategy>)
+        {
+            return *this = SharedStrategy(std::forward<TItem>(Value));
+        }
+
+        // Parses as DefaultStrategy does, see Building
+
+        static SharedStrategy From(Structural::Cursor &Cursor, std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
+        {
+            return Builder::Parse(Cursor, Resource);
+        }
+
+        static SharedStrategy From(Structural::Cursor &Cursor, Statistics &Stats, std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
+        {
+            return Builder::Parse(Cursor, Stats, Resource);
+        }
+
+        static SharedStrategy From(Structural::Cursor &Cursor, Status &Failure, std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
+        {
+            return Builder::Parse(Cursor, Failure, Resource);
+        }
+
+        static Result<SharedStrategy> TryFrom(std::string_view sv, std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
+        {
+            return Builder::TryParse(sv, Resource);
+        }
+
+        template <typename Target>
+        bool Is() const
+        {
+            return std::holds_alternative<Stored<Target>>(Item);
+        }
+
+        template <template <typename> typename TCondition>
+        bool Is() const
+        {
+            using type = typename FirstWhere<TCondition, TO...>::type;
+
+            static_assert(!std::is_same_v<void, type>, "Variant contains no such type");
+
+            return Is<type>();
+        }
+
+        // Copies a shared container before handing it out
+
+        template <typename Target>
+        Target &As()
+        {
+            if constexpr (Counted<Target>)
+                return std::get<Stored<Target>>(Item).Unique();
+            else
+                return std::get<Target>(Item);
+        }
+
+        template <typename Target>
+        Target const &As() const
+        {
+            if constexpr (Counted<Target>)
+                return std::get<Stored<Target>>(Item).Get();
+            else
+                return std::get<Target>(Item);
+        }
+
+        std::size_t Index() const
+        {
+            return Item.index();
+        }
+
+        // Whether both values hold the same container, as copies of each other do until one
+        // of them is modified
+
+        bool Shares(SharedStrategy const &Other) const
+        {
+            if (auto Object = std::get_if<Handle<T>>(&Item))
+                return Other.Is<T>() && Object->Same(std::get<Handle<T>>(Other.Item));
+
+            if (auto Items = std::get_if<Handle<Array>>(&Item))
+                return Other.Is<Array>() && Items->Same(std::get<Handle<Array>>(Other.Item));
+
+            return false;
+        }
+
+        SharedStrategy &operator[](typename T::Key const &Key)
+        {
+            if (!Is<T>())
+                throw std::invalid_argument("Object is not json");
+
+            return As<T>().GetMap()[Key];
+        }
+
+        SharedStrategy &operator[](std::size_t Index)
+        {
+            if (!Is<Array>())
+                throw std::invalid_argument("Object is not array");
+
+            return As<Array>()[Index];
+        }
+
+        // Lookups that neither throw nor insert, see Recursive::Find. The non const ones only
+        // copy a shared container when there is something to hand out.
+
+        SharedStrategy *Find(typename T::Key const &Key)
+        {
+            if (!std::as_const(*this).Find(Key))
+                return nullptr;
+
+            return &As<T>().GetMap().find(Key)->second;
+        }
+
+        SharedStrategy const *Find(typename T::Key const &Key) const
+        {
+            if (!Is<T>())
+                return nullptr;
+
+            auto &Members = As<T>().GetMap();
+            auto It = Members.find(Key);
+
+            return It != Members.end() ? &It->second : nullptr;
+        }
+
+        SharedStrategy *Find(std::size_t Index)
+        {
+            if (!std::as_const(*this).Find(Index))
+                return nullptr;
+
+            return &As<Array>()[Index];
+        }
+
+        SharedStrategy const *Find(std::size_t Index) const
+        {
+            if (!Is<Array>() || Index >= As<Array>().size())
+                return nullptr;
+
+            return &As<Array>()[Index];
+        }
+
+        template <typename Target>
+        Target *TryAs()
+        {
+            return Is<Target>() ? &As<Target>() : nullptr;
+        }
+
+        template <typename Target>
+        Target const *TryAs() const
+        {
+            return Is<Target>() ? &As<Target>() : nullptr;
+        }
+
+        template <typename Target>
+        std::optional<Target> TryGet(typename T::Key const &Key) const
+        {
+            if (auto Member = Find(Key))
+            {
+                if (auto Value = Member->template TryAs<Target>())
+                    return *Value;
+            }
+
+            return std::nullopt;
+        }
+
+        decltype(auto) Visit(auto &&Visitor)
+        {
+            return std::visit([&]<typename TItem>(TItem &Value) -> decltype(auto)
+                              {
+                                  if constexpr (Counting<TItem>)
+                                      return Visitor(Value.Unique());
+                                  else
+                                      return Visitor(Value); },
+                              Item);
+        }
+
+        decltype(auto) Visit(auto &&Visitor) const
+        {
+            return std::visit([&]<typename TItem>(TItem const &Value) -> decltype(auto)
+                              {
+                                  if constexpr (Counting<TItem>)
+                                      return Visitor(Value.Get());
+                                  else
+                                      return Visitor(Value); },
+                              Item);
+        }
+
+        // Shared containers are equal without being compared
+
+        bool operator==(SharedStrategy const &Other) const
+        {
+            return Item == Other.Item;
+        }
+
+        template <typename Types>
+        bool operator==(Types const &Other) const
+            requires(!std::is_same_v<Types, SharedStrategy>)
+        {
+            using TResult = typename decltype(Traits::template Strategy<std::decay_t<Types>>())::type;
+
+            return Is<TResult>() && As<TResult>() == TResult(Other);
+        }
+
+        template <typename TSerializer>
+        friend TSerializer &operator<<(TSerializer &os, SharedStrategy const &value)
+        {
+            return Traits::Write(os, value);
+        }
+
+    private:
+        // A container allocated along with its count and the resource it came from
+
+        template <typename TItem>
+        class Handle
+        {
+        public:
+            Handle(TItem &&Item, std::pmr::memory_resource *Resource)
+            {
+                auto Memory = Resource->allocate(sizeof(Node), alignof(Node));
+
+                Pointer = new (Memory) Node{{1}, Resource, std::move(Item)};
+            }
+
+            Handle(Handle const &Other)
+                : Pointer(Other.Pointer)
+            {
+                if (Pointer)
+                    Pointer->Count.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            Handle(Handle &&Other) noexcept
+                : Pointer(std::exchange(Other.Pointer, nullptr))
+            {
+            }
+
+            Handle &operator=(Handle Other) noexcept
+            {
+                std::swap(Pointer, Other.Pointer);
+
+                return *this;
+            }
+
+            ~Handle()
+            {
+                if (Pointer && Pointer->Count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    auto Resource = Pointer->Resource;
+
+                    Pointer->~Node();
+                    Resource->deallocate(Pointer, sizeof(Node), alignof(Node));
+                }
+            }
+
+            TItem const &Get() const
+            {
+                return Pointer->Item;
+            }
+
+            // Copies the container when another handle holds it as well. The copy is made on
+            // the same resource, its members being shared in turn.
+
+            TItem &Unique()
+            {
+                if (Pointer->Count.load(std::memory_order_acquire) != 1)
+                {
+                    auto Copy = Allocate<TItem>(Pointer->Resource);
+
+                    Copy = Pointer->Item;
+
+                    *this = Handle(std::move(Copy), Pointer->Resource);
+                }
+
+                return Pointer->Item;
+            }
+
+            bool Same(Handle const &Other) const
+            {
+                return Pointer == Other.Pointer;
+            }
+
+            bool operator==(Handle const &Other) const
+            {
+                return Same(Other) || Get() == Other.Get();
+            }
+
+        private:
+            struct Node
+            {
+                std::atomic<std::size_t> Count;
+                std::pmr::memory_resource *Resource;
+                TItem Item;
+            };
+
+            Node *Pointer;
+        };
+
+        template <typename TItem>
+        constexpr static bool Counted = std::is_same_v<TItem, T> || std::is_same_v<TItem, Array>;
+
+        template <typename TItem>
+        constexpr static bool Counting = std::is_same_v<TItem, Handle<T>> || std::is_same_v<TItem, Handle<Array>>;
+
+        template <typename TItem>
+        using Stored = std::conditional_t<Counted<TItem>, Handle<TItem>, TItem>;
+
+        using Null = typename FirstWhere<Traits::template is_null, TO...>::type;
+
+        std::variant<Handle<T>, Handle<Array>, TO...> Item{std::in_place_type<Null>, nullptr};
+
+        template <typename TItem>
+        void Emplace(TItem &&Value, std::pmr::memory_resource *Resource)
+        {
+            using Type = std::decay_t<TItem>;
+
+            if constexpr (Counted<Type>)
+                Item.template emplace<Handle<Type>>(Type(std::forward<TItem>(Value)), Resource);
+            else
+                Item.template emplace<Type>(std::forward<TItem>(Value));
+        }
+
+        void Reset()
+        {
+            Item.template emplace<Null>(nullptr);
+        }
+    };
+}
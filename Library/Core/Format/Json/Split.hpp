@@ -0,0 +1,208 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <string_view>
+#include <algorithm>
+#include <initializer_list>
+#include <memory_resource>
+
+#include "../Json.hpp"
+#include "Parallel.hpp"
+#include "Structural.hpp"
+
+// Parallel parsing of one large array. The structural index of the whole input is built
+// first, then the elements of the array are delimited by counting brackets over it, the way
+// Cursor::Raw skips a value, and handed out in runs to the threads. Each thread parses its
+// runs through its own cursor into the same index and the results are moved into the array
+// in input order, so the tree is the one the sequential parse gives.
+//
+// The array is the root of the document or the member reached from it through a list of
+// keys, everything around it being parsed sequentially. Resource is used from all threads
+// at once and has to be thread safe, the heap being. Malformed arrays are left to the
+// sequential parse, those whose brackets match but whose elements don't parse as well once
+// the threads report them. That takes strategies reporting failures, see Building::Parse,
+// the tree otherwise only matching the sequential one for valid elements.
+
+namespace Core::Split
+{
+    // Parses the array the cursor points at, leaving the cursor right after it
+
+    template <typename TValue>
+    TValue Array(Structural::Cursor &Cursor, std::size_t Threads = Parallel::Workers(), std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
+    {
+        if (Cursor.Peek() != '[' || Threads < 2)
+            return TValue::From(Cursor, Resource);
+
+        auto Start = Cursor;
+        std::vector<Structural::Cursor> Elements;
+
+        Cursor.Next();
+
+        if (Cursor.Peek() != ']')
+        {
+            while (true)
+            {
+                if (Cursor.End() || (Structural::IsOperator(Cursor.Peek()) && Cursor.Peek() != '{' && Cursor.Peek() != '['))
+                    break;
+
+                Elements.push_back(Cursor);
+                Cursor.Raw();
+
+                if (Cursor.Peek() != ',')
+                    break;
+
+                Cursor.Next();
+            }
+
+            if (Cursor.Peek() != ']')
+            {
+                Cursor = Start;
+
+                return TValue::From(Cursor, Resource);
+            }
+        }
+
+        Cursor.Next();
+
+        // A few runs per thread so a thread stuck on large elements doesn't hold the others back
+
+        std::size_t Runs = std::min(Elements.size(), Threads * 8);
+        std::vector<std::vector<TValue>> Parsed(Runs);
+        std::atomic<bool> Malformed = false;
+
+        Parallel::For(
+            Runs, [&](std::size_t Run)
+            {
+                std::size_t First = Elements.size() * Run / Runs, Last = Elements.size() * (Run + 1) / Runs;
+
+                Parsed[Run].reserve(Last - First);
+
+                for (std::size_t i = First; i < Last && !Malformed.load(std::memory_order_relaxed); ++i)
+                {
+                    if constexpr (requires(Status Failure) { TValue::From(Elements[i], Failure, Resource); })
+                    {
+                        Status Failure;
+
+                        Parsed[Run].push_back(TValue::From(Elements[i], Failure, Resource));
+
+                        if (Failure.Failed())
+                            Malformed.store(true, std::memory_order_relaxed);
+                    }
+                    else
+                    {
+                        Parsed[Run].push_back(TValue::From(Elements[i], Resource));
+                    }
+                } },
+            Threads);
+
+        // Elements after a malformed one are dropped by the sequential parse, which is redone
+        // so the array and the cursor end up the way it leaves them
+
+        if (Malformed)
+        {
+            Cursor = Start;
+
+            return TValue::From(Cursor, Resource);
+        }
+
+        auto Result = Allocate<typename TValue::Array>(Resource);
+
+        Result.reserve(Elements.size());
+
+        for (auto &Run : Parsed)
+        {
+            for (auto &Item : Run)
+                Result.push_back(std::move(Item));
+        }
+
+        return Result;
+    }
+
+    // Parses the value at the cursor, following Path down to the array parsed in parallel
+
+    template <typename TValue>
+    TValue Descend(Structural::Cursor &Cursor, std::initializer_list<std::string_view> Path, std::size_t Level, std::size_t Threads, std::pmr::memory_resource *Resource)
+    {
+        using Json = typename TValue::Json;
+
+        if (Level == Path.size())
+            return Array<TValue>(Cursor, Threads, Resource);
+
+        if (Cursor.Peek() != '{')
+            return TValue::From(Cursor, Resource);
+
+        auto Object = Allocate<Json>(Resource);
+
+        Cursor.Next();
+
+        if (Cursor.Peek() == '}')
+        {
+            Cursor.Next();
+
+            return Object;
+        }
+
+        while (Cursor.Peek() == '"')
+        {
+            auto Raw = Cursor.String();
+            auto Escaped = Escape::Classify(Raw, Cursor);
+            auto Key = Escape::Make<typename Json::Key>(Raw, Escaped, Resource);
+
+            if (!Key)
+                Escape::Require<typename Json::Key>(Raw, Escaped == Escape::Kind::Escaped, Resource);
+
+            if (!Key || Cursor.Peek() != ':')
+            {
+                Cursor.Finish();
+                break;
+            }
+
+            Cursor.Next();
+
+            bool Designated = std::string_view(*Key) == Path.begin()[Level];
+
+            Object.Insert(std::move(*Key), Designated ? Descend<TValue>(Cursor, Path, Level + 1, Threads, Resource)
+                                                      : TValue::From(Cursor, Resource));
+
+            if (Cursor.Peek() != ',')
+                break;
+
+            Cursor.Next();
+        }
+
+        if (Cursor.Peek() == '}')
+            Cursor.Next();
+        else
+            Cursor.Finish();
+
+        return Object;
+    }
+
+    // Parses a whole document into TDocument, either a strategy or a Json instantiation which
+    // is left empty when the root isn't an object
+
+    template <typename TDocument>
+    TDocument From(std::string_view sv, std::initializer_list<std::string_view> Path = {}, std::size_t Threads = Parallel::Workers(),
+                   std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
+    {
+        Structural::Index Positions{sv};
+        Structural::Cursor Cursor{Positions};
+
+        if constexpr (requires { typename TDocument::Builder; })
+        {
+            return Descend<TDocument>(Cursor, Path, 0, Threads, Resource);
+        }
+        else
+        {
+            auto Result = Allocate<TDocument>(Resource);
+
+            if (auto Root = Descend<typename TDocument::Value>(Cursor, Path, 0, Threads, Resource); Root.template Is<TDocument>())
+                Result = std::move(Root.template As<TDocument>());
+
+            return Result;
+        }
+    }
+}
@@ -0,0 +1,343 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <string_view>
+#include <type_traits>
+#include <memory_resource>
+
+#include "Sax.hpp"
+#include "Escape.hpp"
+#include "Arena.hpp"
+#include "Number.hpp"
+
+// What a parse went through, filled in by the overloads of From taking a Statistics: bytes
+// consumed, nodes of each kind, deepest nesting, strings copied out of the input, allocations
+// and the time spent building the structural index and then the tree. Allocations are read
+// off the resource when it is an Arena or a CountingResource, the others don't report them.
+//
+// The overloads instrument the parse by wrapping its handler, the plain ones are left as
+// they are. Defining CORE_JSON_STATISTICS to 0 turns the instrumented ones into the plain
+// ones as well, leaving the statistics untouched.
+//
+// Statistics of several calls add up with +=, Totals does the same from several threads.
+
+#ifndef CORE_JSON_STATISTICS
+#define CORE_JSON_STATISTICS 1
+#endif
+
+namespace Core
+{
+    struct Statistics
+    {
+        constexpr static bool Enabled = CORE_JSON_STATISTICS;
+
+        std::size_t Documents = 0;
+        std::size_t Bytes = 0;
+
+        std::size_t Objects = 0;
+        std::size_t Arrays = 0;
+        std::size_t Keys = 0;
+        std::size_t Strings = 0;
+        std::size_t Numbers = 0;
+        std::size_t Booleans = 0;
+        std::size_t Nulls = 0;
+
+        std::size_t Depth = 0;
+
+        // Strings and keys copied out of the input rather than viewed in place
+
+        std::size_t Copies = 0;
+        std::size_t CopiedBytes = 0;
+
+        std::size_t Allocations = 0;
+        std::size_t AllocatedBytes = 0;
+
+        std::chrono::nanoseconds Indexing{};
+        std::chrono::nanoseconds Building{};
+
+        Statistics &operator+=(Statistics const &Other)
+        {
+            Documents += Other.Documents;
+            Bytes += Other.Bytes;
+            Objects += Other.Objects;
+            Arrays += Other.Arrays;
+            Keys += Other.Keys;
+            Strings += Other.Strings;
+            Numbers += Other.Numbers;
+            Booleans += Other.Booleans;
+            Nulls += Other.Nulls;
+            Depth = std::max(Depth, Other.Depth);
+            Copies += Other.Copies;
+            CopiedBytes += Other.CopiedBytes;
+            Allocations += Other.Allocations;
+            AllocatedBytes += Other.AllocatedBytes;
+            Indexing += Other.Indexing;
+            Building += Other.Building;
+
+            return *this;
+        }
+
+        // Allocations and bytes served by Resource so far, zero when it doesn't count them
+
+        static std::pair<std::size_t, std::size_t> Usage(std::pmr::memory_resource *Resource)
+        {
+            if (auto Counted = dynamic_cast<Arena *>(Resource))
+                return {Counted->Allocations(), Counted->BytesAllocated()};
+
+            if (auto Counted = dynamic_cast<CountingResource *>(Resource))
+                return {Counted->Allocations(), Counted->BytesAllocated()};
+
+            return {0, 0};
+        }
+
+        // Times the building of one document out of Cursor, takes the allocations made in
+        // between and the bytes the cursor went over. The index is built before the cursor
+        // exists, the overloads taking the text time it themselves.
+
+        class Scope
+        {
+        public:
+            using Clock = std::chrono::steady_clock;
+
+            Scope(Statistics &Stats, Structural::Cursor const &Cursor, std::pmr::memory_resource *Resource)
+                : Stats(Stats), Cursor(Cursor), Resource(Resource), Before(Usage(Resource)), Offset(Cursor.Offset()), Start(Clock::now())
+            {
+            }
+
+            Scope(Scope const &) = delete;
+            Scope &operator=(Scope const &) = delete;
+
+            ~Scope()
+            {
+                auto After = Usage(Resource);
+
+                ++Stats.Documents;
+                Stats.Bytes += (Cursor.End() ? Cursor.GetSource().size() : Cursor.Offset()) - Offset;
+                Stats.Allocations += After.first - Before.first;
+                Stats.AllocatedBytes += After.second - Before.second;
+                Stats.Building += Clock::now() - Start;
+            }
+
+        private:
+            Statistics &Stats;
+            Structural::Cursor const &Cursor;
+            std::pmr::memory_resource *Resource;
+            std::pair<std::size_t, std::size_t> Before;
+            std::size_t Offset;
+            Clock::time_point Start;
+        };
+    };
+
+    // Sax handler counting the events it forwards to Inner. TKey and TString are the types the
+    // keys and strings end up in, which tell whether they get copied, see Escape::Copies.
+
+    template <typename THandler, typename TKey, typename TString>
+    class Instrumented
+    {
+    public:
+        constexpr static bool Decode = Sax::Decoding<THandler>;
+
+        Instrumented(THandler &Inner, Statistics &Stats, std::pmr::memory_resource *Resource)
+            : Inner(Inner), Stats(Stats), Resource(Resource)
+        {
+        }
+
+        bool StartObject()
+        {
+            ++Stats.Objects;
+            Stats.Depth = std::max(Stats.Depth, ++Depth);
+
+            return Sax::Emit([&]
+                             { return Inner.StartObject(); });
+        }
+
+        bool StartArray()
+        {
+            ++Stats.Arrays;
+            Stats.Depth = std::max(Stats.Depth, ++Depth);
+
+            return Sax::Emit([&]
+                             { return Inner.StartArray(); });
+        }
+
+        bool EndObject()
+        {
+            --Depth;
+
+            return Sax::Emit([&]
+                             { return Inner.EndObject(); });
+        }
+
+        bool EndArray()
+        {
+            --Depth;
+
+            return Sax::Emit([&]
+                             { return Inner.EndArray(); });
+        }
+
+        bool Key(std::string_view Raw, bool Escaped)
+            requires(!Decode)
+        {
+            ++Stats.Keys;
+            Copied<TKey>(Raw, Escaped);
+
+            return Sax::Emit([&]
+                             { return Inner.Key(Raw, Escaped); });
+        }
+
+        bool String(std::string_view Raw, bool Escaped)
+            requires(!Decode)
+        {
+            ++Stats.Strings;
+            Copied<TString>(Raw, Escaped);
+
+            return Sax::Emit([&]
+                             { return Inner.String(Raw, Escaped); });
+        }
+
+        bool Key(std::string_view Text)
+            requires(Decode)
+        {
+            ++Stats.Keys;
+
+            return Sax::Emit([&]
+                             { return Inner.Key(Text); });
+        }
+
+        bool String(std::string_view Text)
+            requires(Decode)
+        {
+            ++Stats.Strings;
+
+            return Sax::Emit([&]
+                             { return Inner.String(Text); });
+        }
+
+        bool Integer(std::int64_t Value)
+        {
+            ++Stats.Numbers;
+
+            return Sax::Emit([&]
+                             { return Inner.Integer(Value); });
+        }
+
+        bool Double(double Value)
+        {
+            ++Stats.Numbers;
+
+            return Sax::Emit([&]
+                             { return Inner.Double(Value); });
+        }
+
+        bool Number(Core::Number Value)
+            requires(requires(THandler &Handler) { Handler.Number(Core::Number{}); })
+        {
+            ++Stats.Numbers;
+
+            return Sax::Emit([&]
+                             { return Inner.Number(Value); });
+        }
+
+        bool Boolean(bool Value)
+        {
+            ++Stats.Booleans;
+
+            return Sax::Emit([&]
+                             { return Inner.Boolean(Value); });
+        }
+
+        bool Null()
+        {
+            ++Stats.Nulls;
+
+            return Sax::Emit([&]
+                             { return Inner.Null(); });
+        }
+
+    private:
+        THandler &Inner;
+        Statistics &Stats;
+        std::pmr::memory_resource *Resource;
+        std::size_t Depth = 0;
+
+        template <typename T>
+        void Copied(std::string_view Raw, bool Escaped)
+        {
+            if (Escape::Copies<T>(Escaped, Resource))
+            {
+                ++Stats.Copies;
+                Stats.CopiedBytes += Raw.size();
+            }
+        }
+    };
+
+    // Statistics added from several threads at once
+
+    class Totals
+    {
+    public:
+        void Add(Statistics const &Stats)
+        {
+            Documents.fetch_add(Stats.Documents, std::memory_order_relaxed);
+            Bytes.fetch_add(Stats.Bytes, std::memory_order_relaxed);
+            Objects.fetch_add(Stats.Objects, std::memory_order_relaxed);
+            Arrays.fetch_add(Stats.Arrays, std::memory_order_relaxed);
+            Keys.fetch_add(Stats.Keys, std::memory_order_relaxed);
+            Strings.fetch_add(Stats.Strings, std::memory_order_relaxed);
+            Numbers.fetch_add(Stats.Numbers, std::memory_order_relaxed);
+            Booleans.fetch_add(Stats.Booleans, std::memory_order_relaxed);
+            Nulls.fetch_add(Stats.Nulls, std::memory_order_relaxed);
+            Copies.fetch_add(Stats.Copies, std::memory_order_relaxed);
+            CopiedBytes.fetch_add(Stats.CopiedBytes, std::memory_order_relaxed);
+            Allocations.fetch_add(Stats.Allocations, std::memory_order_relaxed);
+            AllocatedBytes.fetch_add(Stats.AllocatedBytes, std::memory_order_relaxed);
+            Indexing.fetch_add(Stats.Indexing.count(), std::memory_order_relaxed);
+            Building.fetch_add(Stats.Building.count(), std::memory_order_relaxed);
+
+            auto Deepest = Depth.load(std::memory_order_relaxed);
+
+            while (Deepest < Stats.Depth && !Depth.compare_exchange_weak(Deepest, Stats.Depth, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        // The sum so far, each counter being read on its own while others may be adding
+
+        Statistics Load() const
+        {
+            Statistics Result;
+
+            Result.Documents = Documents.load(std::memory_order_relaxed);
+            Result.Bytes = Bytes.load(std::memory_order_relaxed);
+            Result.Objects = Objects.load(std::memory_order_relaxed);
+            Result.Arrays = Arrays.load(std::memory_order_relaxed);
+            Result.Keys = Keys.load(std::memory_order_relaxed);
+            Result.Strings = Strings.load(std::memory_order_relaxed);
+            Result.Numbers = Numbers.load(std::memory_order_relaxed);
+            Result.Booleans = Booleans.load(std::memory_order_relaxed);
+            Result.Nulls = Nulls.load(std::memory_order_relaxed);
+            Result.Depth = Depth.load(std::memory_order_relaxed);
+            Result.Copies = Copies.load(std::memory_order_relaxed);
+            Result.CopiedBytes = CopiedBytes.load(std::memory_order_relaxed);
+            Result.Allocations = Allocations.load(std::memory_order_relaxed);
+            Result.AllocatedBytes = AllocatedBytes.load(std::memory_order_relaxed);
+            Result.Indexing = std::chrono::nanoseconds{Indexing.load(std::memory_order_relaxed)};
+            Result.Building = std::chrono::nanoseconds{Building.load(std::memory_order_relaxed)};
+
+            return Result;
+        }
+
+    private:
+        std::atomic<std::size_t> Documents{0}, Bytes{0};
+        std::atomic<std::size_t> Objects{0}, Arrays{0}, Keys{0}, Strings{0}, Numbers{0}, Booleans{0}, Nulls{0};
+        std::atomic<std::size_t> Depth{0};
+        std::atomic<std::size_t> Copies{0}, CopiedBytes{0};
+        std::atomic<std::size_t> Allocations{0}, AllocatedBytes{0};
+        std::atomic<std::chrono::nanoseconds::rep> Indexing{0}, Building{0};
+    };
+}
@@ -0,0 +1,288 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <string_view>
+
+#include "Sax.hpp"
+
+// Resumable push parser for input arriving in chunks. It reports the same events as Sax::Parse
+// and keeps the nesting and any partially read token between calls, so nothing has to be
+// buffered up front. Strings and scalars that are complete within a chunk are handed out as
+// views into that chunk, only the ones straddling a boundary are copied into a pending buffer.
+// Either way the views only live until the callback returns, as do the decoded strings.
+
+namespace Core::Sax
+{
+    enum class Status
+    {
+        NeedMore,
+        Complete,
+        Error
+    };
+
+    template <typename THandler>
+    class Stream
+    {
+    public:
+        explicit Stream(THandler &Handler)
+            : Handler(Handler)
+        {
+        }
+
+        // Consumes Chunk until either it runs out (NeedMore) or a top level value is complete
+        // (Complete), in which case Chunk is left with the bytes following that value so
+        // several values can be read off the same stream
+
+        Status Feed(std::string_view &Chunk)
+        {
+            std::size_t i = 0;
+
+            while (true)
+            {
+                if (Current == State::Close && Levels.Empty())
+                {
+                    Current = State::Value;
+                    Chunk.remove_prefix(i);
+
+                    return Status::Complete;
+                }
+
+                if (i == Chunk.size() || Current == State::Error)
+                    break;
+
+                char c = Chunk[i];
+
+                if (Current == State::String)
+                {
+                    std::size_t Start = i;
+
+                    while (i < Chunk.size())
+                    {
+                        if (Escaped)
+                        {
+                            Escaped = false;
+                            ++i;
+                            continue;
+                        }
+
+                        i = Chunk.find_first_of("\"\\", i);
+
+                        if (i == std::string_view::npos)
+                            i = Chunk.size();
+                        else if (Chunk[i] == '"')
+                            break;
+                        else
+                        {
+                            Escaped = true;
+                            ++i;
+                        }
+                    }
+
+                    if (!Token(Chunk.substr(Start, i - Start), i == Chunk.size()))
+                        continue;
+
+                    ++i;
+
+                    Check(Text(View, Escape::Classify(View), InKey, Handler, Scratch), InKey ? State::Colon : State::Close);
+                }
+                else if (Current == State::Scalar)
+                {
+                    std::size_t Start = i;
+
+                    while (i < Chunk.size() && !Structural::IsOperator(Chunk[i]) && !Structural::IsWhiteSpace(Chunk[i]) && Chunk[i] != '"')
+                        ++i;
+
+                    if (!Token(Chunk.substr(Start, i - Start), i == Chunk.size()))
+                        continue;
+
+                    Check(Scalar(View, Handler), State::Close);
+                }
+                else if (Structural::IsWhiteSpace(c))
+                {
+                    ++i;
+                }
+                else if (Current == State::Value || Current == State::FirstValue)
+                {
+                    ++i;
+
+                    if (c == '{')
+                        Check(Emit([&]
+                                   { return Handler.StartObject(); }) &&
+                                  Levels.Push(true),
+                              State::FirstKey);
+                    else if (c == '[')
+                        Check(Emit([&]
+                                   { return Handler.StartArray(); }) &&
+                                  Levels.Push(false),
+                              State::FirstValue);
+                    else if (c == ']' && Current == State::FirstValue)
+                        Close();
+                    else if (c == '"')
+                        Current = State::String;
+                    else if (Structural::IsOperator(c))
+                        Current = State::Error;
+                    else
+                        Current = State::Scalar;
+
+                    // Scalars have no opening character, read them from their first byte
+
+                    if (Current == State::Scalar)
+                        --i;
+
+                    InKey = false;
+                }
+                else if (Current == State::FirstKey || Current == State::Key)
+                {
+                    ++i;
+
+                    if (c == '}' && Current == State::FirstKey)
+                        Close();
+                    else if (c == '"')
+                        Current = State::String;
+                    else
+                        Current = State::Error;
+
+                    InKey = true;
+                }
+                else if (Current == State::Colon)
+                {
+                    ++i;
+
+                    Current = c == ':' ? State::Value : State::Error;
+                }
+                else
+                {
+                    ++i;
+
+                    if (c == ',')
+                        Current = Levels.InObject() ? State::Key : State::Value;
+                    else if ((c == '}' && Levels.InObject()) || (c == ']' && !Levels.InObject()))
+                        Close();
+                    else
+                        Current = State::Error;
+                }
+            }
+
+            Chunk.remove_prefix(i);
+
+            return Current == State::Error ? Status::Error : Status::NeedMore;
+        }
+
+        Status Feed(std::string_view &&Chunk)
+        {
+            return Feed(Chunk);
+        }
+
+        // Signals the end of the input, which completes a top level scalar still being read
+
+        Status Finish()
+        {
+            if (Current == State::Scalar && Levels.Empty())
+            {
+                Check(Scalar(Pending, Handler), State::Close);
+
+                Pending.clear();
+                Spilled = false;
+            }
+
+            if (Current == State::Close && Levels.Empty())
+            {
+                Current = State::Value;
+                return Status::Complete;
+            }
+
+            return Current == State::Value && Levels.Empty() ? Status::NeedMore : Status::Error;
+        }
+
+        void Reset()
+        {
+            Current = State::Value;
+            Levels = {};
+            Pending.clear();
+            Spilled = Escaped = InKey = false;
+        }
+
+        std::size_t Depth() const
+        {
+            return Levels.Size();
+        }
+
+    private:
+        enum class State : std::uint8_t
+        {
+            Value,
+            FirstValue,
+            FirstKey,
+            Key,
+            Colon,
+            Close,
+            String,
+            Scalar,
+            Error
+        };
+
+        THandler &Handler;
+        State Current = State::Value;
+        Stack Levels;
+
+        // Token being read, only copied into Pending once it crosses a chunk boundary
+
+        std::string Pending;
+        std::string Scratch;
+        std::string_view View;
+        bool Spilled = false;
+        bool Escaped = false;
+        bool InKey = false;
+
+        // Returns false and keeps the piece when the token continues in the next chunk,
+        // otherwise leaves the whole token in View
+
+        bool Token(std::string_view Piece, bool Partial)
+        {
+            if (Partial)
+            {
+                Pending.append(Piece);
+                Spilled = true;
+
+                return false;
+            }
+
+            if (Spilled)
+            {
+                Pending.append(Piece);
+                View = Pending;
+            }
+            else
+            {
+                View = Piece;
+            }
+
+            return true;
+        }
+
+        void Check(bool Success, State Next)
+        {
+            Current = Success ? Next : State::Error;
+
+            if (Spilled)
+            {
+                Pending.clear();
+                Spilled = false;
+            }
+        }
+
+        void Close()
+        {
+            bool Object = Levels.InObject();
+
+            Levels.Pop();
+
+            Check(Object ? Emit([&]
+                                { return Handler.EndObject(); })
+                         : Emit([&]
+                                { return Handler.EndArray(); }),
+                  State::Close);
+        }
+    };
+}
@@ -0,0 +1,456 @@
+#pragma once
+
+#include <bit>
+#include <limits>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CORE_JSON_X86 1
+#endif
+
+// First parsing stage : classifies the input 64 bytes at a time and records the position of
+// every structural character ({ } [ ] : ,), every unescaped quote and the first byte of every
+// scalar outside of strings. The tree builders then walk these positions instead of the bytes.
+// Positions are 32 bits wide, inputs longer than MaxSize are rejected.
+
+namespace Core::Structural
+{
+    enum class Level
+    {
+        Scalar,
+        Sse42,
+        Avx2
+    };
+
+    // Bit i of each mask describes byte i of the 64 byte block
+
+    struct Block
+    {
+        std::uint64_t Quote;
+        std::uint64_t Backslash;
+        std::uint64_t Operator;
+        std::uint64_t Space;
+        std::uint64_t Control;
+        std::uint64_t High;
+    };
+
+    inline constexpr bool IsOperator(char c)
+    {
+        return c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',';
+    }
+
+    inline constexpr bool IsWhiteSpace(char c)
+    {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    inline Block ClassifyScalar(char const *Data)
+    {
+        Block Result{};
+
+        for (std::size_t i = 0; i < 64; ++i)
+        {
+            std::uint64_t Bit = std::uint64_t{1} << i;
+
+            if (Data[i] == '"')
+                Result.Quote |= Bit;
+            else if (Data[i] == '\\')
+                Result.Backslash |= Bit;
+            else if (IsOperator(Data[i]))
+                Result.Operator |= Bit;
+            else if (IsWhiteSpace(Data[i]))
+                Result.Space |= Bit;
+
+            if (static_cast<unsigned char>(Data[i]) < 0x20)
+                Result.Control |= Bit;
+            else if (static_cast<unsigned char>(Data[i]) >= 0x80)
+                Result.High |= Bit;
+        }
+
+        return Result;
+    }
+
+#ifdef CORE_JSON_X86
+
+    __attribute__((target("sse4.2"))) inline std::uint64_t Match16(__m128i const (&Chunks)[4], char c)
+    {
+        __m128i Needle = _mm_set1_epi8(c);
+        std::uint64_t Result = 0;
+
+        for (int i = 0; i < 4; ++i)
+            Result |= std::uint64_t(std::uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(Chunks[i], Needle)))) << (i * 16);
+
+        return Result;
+    }
+
+    __attribute__((target("sse4.2"))) inline Block ClassifySse42(char const *Data)
+    {
+        __m128i Chunks[4];
+
+        std::uint64_t Control = 0, High = 0;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            Chunks[i] = _mm_loadu_si128(reinterpret_cast<__m128i const *>(Data + i * 16));
+
+            // Unsigned c <= 0x1F is max(c, 0x1F) == 0x1F
+
+            __m128i Below = _mm_cmpeq_epi8(_mm_max_epu8(Chunks[i], _mm_set1_epi8(0x1F)), _mm_set1_epi8(0x1F));
+
+            Control |= std::uint64_t(std::uint16_t(_mm_movemask_epi8(Below))) << (i * 16);
+            High |= std::uint64_t(std::uint16_t(_mm_movemask_epi8(Chunks[i]))) << (i * 16);
+        }
+
+        return {
+            Match16(Chunks, '"'),
+            Match16(Chunks, '\\'),
+            Match16(Chunks, '{') | Match16(Chunks, '}') | Match16(Chunks, '[') | Match16(Chunks, ']') | Match16(Chunks, ':') | Match16(Chunks, ','),
+            Match16(Chunks, ' ') | Match16(Chunks, '\n') | Match16(Chunks, '\r') | Match16(Chunks, '\t'),
+            Control,
+            High};
+    }
+
+    __attribute__((target("avx2"))) inline std::uint64_t Match32(__m256i Low, __m256i High, char c)
+    {
+        __m256i Needle = _mm256_set1_epi8(c);
+
+        return std::uint64_t(std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(Low, Needle)))) |
+               std::uint64_t(std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(High, Needle)))) << 32;
+    }
+
+    // Bytes below 0x20, unsigned c <= 0x1F being max(c, 0x1F) == 0x1F
+
+    __attribute__((target("avx2"))) inline std::uint64_t Below32(__m256i Low, __m256i High)
+    {
+        __m256i Bound = _mm256_set1_epi8(0x1F);
+
+        return std::uint64_t(std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(Low, Bound), Bound)))) |
+               std::uint64_t(std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(High, Bound), Bound)))) << 32;
+    }
+
+    __attribute__((target("avx2"))) inline Block ClassifyAvx2(char const *Data)
+    {
+        __m256i Low = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(Data));
+        __m256i High = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(Data + 32));
+
+        return {
+            Match32(Low, High, '"'),
+            Match32(Low, High, '\\'),
+            Match32(Low, High, '{') | Match32(Low, High, '}') | Match32(Low, High, '[') | Match32(Low, High, ']') | Match32(Low, High, ':') | Match32(Low, High, ','),
+            Match32(Low, High, ' ') | Match32(Low, High, '\n') | Match32(Low, High, '\r') | Match32(Low, High, '\t'),
+            Below32(Low, High),
+            std::uint64_t(std::uint32_t(_mm256_movemask_epi8(Low))) | std::uint64_t(std::uint32_t(_mm256_movemask_epi8(High))) << 32};
+    }
+
+#endif
+
+    inline Level Detect()
+    {
+#ifdef CORE_JSON_X86
+        static Level const Detected = []
+        {
+            __builtin_cpu_init();
+
+            if (__builtin_cpu_supports("avx2"))
+                return Level::Avx2;
+
+            if (__builtin_cpu_supports("sse4.2"))
+                return Level::Sse42;
+
+            return Level::Scalar;
+        }();
+
+        return Detected;
+#else
+        return Level::Scalar;
+#endif
+    }
+
+    inline Block Classify(char const *Data, Level Use)
+    {
+#ifdef CORE_JSON_X86
+        if (Use == Level::Avx2)
+            return ClassifyAvx2(Data);
+
+        if (Use == Level::Sse42)
+            return ClassifySse42(Data);
+#endif
+
+        return ClassifyScalar(Data);
+    }
+
+    // Marks the characters preceded by an odd number of backslashes, carrying open sequences over blocks
+
+    inline std::uint64_t Escaped(std::uint64_t Backslash, std::uint64_t &Carry)
+    {
+        constexpr std::uint64_t Even = 0x5555555555555555ULL;
+
+        Backslash &= ~Carry;
+
+        std::uint64_t FollowsEscape = Backslash << 1 | Carry;
+        std::uint64_t OddStarts = Backslash & ~Even & ~FollowsEscape;
+        std::uint64_t EvenSequences = OddStarts + Backslash;
+
+        Carry = EvenSequences < OddStarts;
+
+        return (Even ^ (EvenSequences << 1)) & FollowsEscape;
+    }
+
+    inline constexpr std::uint64_t PrefixXor(std::uint64_t Bits)
+    {
+        Bits ^= Bits << 1;
+        Bits ^= Bits << 2;
+        Bits ^= Bits << 4;
+        Bits ^= Bits << 8;
+        Bits ^= Bits << 16;
+        Bits ^= Bits << 32;
+
+        return Bits;
+    }
+
+    // Largest input an index can hold, the end of the input being a position as well
+
+    constexpr std::size_t MaxSize = std::numeric_limits<std::uint32_t>::max();
+
+    class Index
+    {
+    public:
+        Index() = default;
+
+        // Throws std::length_error when sv is longer than MaxSize
+
+        explicit Index(std::string_view sv, Level Use = Detect())
+            : Source(sv), Positions(Reserve(sv.size()))
+        {
+            std::uint64_t EscapeCarry = 0;
+            std::uint64_t StringCarry = 0;
+            std::uint64_t ScalarCarry = 0;
+            std::uint64_t Unusual = 0;
+
+            std::uint32_t *Out = Positions.get();
+
+            for (std::size_t Offset = 0; Offset < sv.size(); Offset += 64)
+            {
+                char Padded[64];
+                char const *Data = sv.data() + Offset;
+
+                if (sv.size() - Offset < 64)
+                {
+                    std::memset(Padded, ' ', 64);
+                    std::memcpy(Padded, Data, sv.size() - Offset);
+                    Data = Padded;
+                }
+
+                Block Masks = Classify(Data, Use);
+
+                std::uint64_t Quote = Masks.Quote & ~Escaped(Masks.Backslash, EscapeCarry);
+
+                // Set from an opening quote up to the character before its closing quote
+
+                std::uint64_t InString = PrefixXor(Quote) ^ StringCarry;
+                StringCarry = std::uint64_t(std::int64_t(InString) >> 63);
+
+                Unusual |= Masks.Backslash | Masks.High | (Masks.Control & InString);
+
+                std::uint64_t Scalar = ~(Masks.Operator | Masks.Space | Quote);
+                std::uint64_t ScalarStart = Scalar & ~(Scalar << 1 | ScalarCarry);
+                ScalarCarry = Scalar >> 63;
+
+                std::uint64_t Bits = ((Masks.Operator | ScalarStart) & ~InString) | Quote;
+
+                while (Bits)
+                {
+                    *Out++ = static_cast<std::uint32_t>(Offset + std::countr_zero(Bits));
+                    Bits &= Bits - 1;
+                }
+            }
+
+            // Sentinel so the walkers can always peek one position ahead
+
+            *Out++ = static_cast<std::uint32_t>(sv.size());
+            Count = Out - Positions.get();
+            Simple = !Unusual;
+        }
+
+        std::string_view GetSource() const
+        {
+            return Source;
+        }
+
+        // Whether the input holds neither backslashes, control characters within strings nor
+        // anything outside of ASCII, in which case its strings need no further checks
+
+        bool Plain() const
+        {
+            return Simple;
+        }
+
+        std::uint32_t const *begin() const
+        {
+            return Positions.get();
+        }
+
+        std::uint32_t const *end() const
+        {
+            return Positions.get() + Count;
+        }
+
+        std::size_t Size() const
+        {
+            return Count - 1;
+        }
+
+    private:
+        std::string_view Source;
+        std::unique_ptr<std::uint32_t[]> Positions;
+
+        static std::unique_ptr<std::uint32_t[]> Reserve(std::size_t Size)
+        {
+            if (Size > MaxSize)
+                throw std::length_error("Input too large to index");
+
+            return std::make_unique_for_overwrite<std::uint32_t[]>(Size + 1);
+        }
+
+        std::size_t Count = 0;
+        bool Simple = true;
+    };
+
+    // Walks an index one token at a time, Peek() yields '\0' once the input is exhausted
+
+    class Cursor
+    {
+    public:
+        explicit Cursor(Index const &Positions)
+            : Source(Positions.GetSource()), Position(Positions.begin()), Last(Positions.end() - 1), Simple(Positions.Plain())
+        {
+        }
+
+        inline char Peek() const
+        {
+            return Position < Last ? Source[*Position] : '\0';
+        }
+
+        inline std::size_t Offset() const
+        {
+            return *Position;
+        }
+
+        inline void Next()
+        {
+            if (Position < Last)
+                ++Position;
+        }
+
+        inline void Finish()
+        {
+            Position = Last;
+        }
+
+        inline bool End() const
+        {
+            return Position == Last;
+        }
+
+        // Consumes the opening and closing quotes and returns the raw content in between
+
+        inline std::string_view String()
+        {
+            std::size_t Start = *Position + 1;
+
+            Next();
+
+            std::size_t Stop = *Position;
+
+            Next();
+
+            return Source.substr(Start, Stop - Start);
+        }
+
+        // Whether Raw, as returned by String, ended on its closing quote rather than on the end
+        // of the input
+
+        inline bool Closed(std::string_view Raw) const
+        {
+            std::size_t Stop = Raw.data() + Raw.size() - Source.data();
+
+            return Stop < Source.size() && Source[Stop] == '"';
+        }
+
+        // Consumes a scalar token running until the next structural position or white space
+
+        inline std::string_view Scalar()
+        {
+            std::size_t Start = *Position;
+
+            Next();
+
+            std::size_t Stop = *Position;
+
+            while (Stop > Start && IsWhiteSpace(Source[Stop - 1]))
+                --Stop;
+
+            return Source.substr(Start, Stop - Start);
+        }
+
+        // Consumes the value at the cursor and returns its text, quotes included for strings.
+        // Containers are skipped by counting brackets without looking at what they hold.
+
+        inline std::string_view Raw()
+        {
+            std::size_t Start = *Position;
+            std::size_t Depth = 0;
+
+            char Token = Peek();
+
+            if (Token == '"')
+            {
+                String();
+
+                return Source.substr(Start, Position[-1] + 1 - Start);
+            }
+
+            if (Token != '{' && Token != '[')
+                return Scalar();
+
+            do
+            {
+                Token = Peek();
+
+                if (Token == '{' || Token == '[')
+                    ++Depth;
+                else if (Token == '}' || Token == ']')
+                    --Depth;
+
+                Next();
+            } while (Depth && !End());
+
+            // Unterminated containers run until the end of the input
+
+            return Source.substr(Start, Depth ? std::string_view::npos : Position[-1] + 1 - Start);
+        }
+
+        inline std::string_view GetSource() const
+        {
+            return Source;
+        }
+
+        // See Index::Plain
+
+        inline bool Plain() const
+        {
+            return Simple;
+        }
+
+    private:
+        std::string_view Source;
+        std::uint32_t const *Position;
+        std::uint32_t const *Last;
+        bool Simple;
+    };
+}
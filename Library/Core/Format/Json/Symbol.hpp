@@ -0,0 +1,299 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <compare>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <string_view>
+#include <shared_mutex>
+#include <memory_resource>
+
+// Interned keys. Records of the same schema repeat the same few keys over and over, a
+// Core::Symbol stores each distinct key once in a pool and is itself a single pointer to it,
+// so a document keyed by symbols holds 8 bytes per member instead of a string of its own.
+// Keys of the same pool are the same pointer, which is all equality compares for them.
+//
+// Symbols intern into the pool of the Symbol::Session open on the thread, or into a process
+// wide pool shared by the threads without one. Pools never release a key before they are
+// destroyed, and have to outlive every symbol made out of them. The shared pool lasts until
+// the process exits and grows with every distinct key parsed outside of a session, so input
+// with arbitrary keys belongs in a session whose pool goes away with its documents.
+//
+// Looking a key up by converting text to a symbol interns it as well. Symbol::Find doesn't,
+// handing out a null symbol equal to no key when the text isn't in the pool.
+
+namespace Core
+{
+    class Symbol
+    {
+    public:
+        struct Entry
+        {
+            std::size_t Hash;
+            std::size_t Size;
+            char const *Data;
+        };
+
+        // Open addressing over the entries, their text being allocated next to them from a
+        // monotonic resource. Not synchronised, one is meant to serve a single parser session.
+
+        class Pool
+        {
+        public:
+            explicit Pool(std::pmr::memory_resource *Upstream = std::pmr::get_default_resource())
+                : Storage(Upstream), Slots(Upstream)
+            {
+            }
+
+            Pool(Pool const &) = delete;
+            Pool &operator=(Pool const &) = delete;
+
+            Entry const *Find(std::string_view Text, std::size_t Hash) const
+            {
+                if (Slots.empty())
+                    return nullptr;
+
+                std::size_t Mask = Slots.size() - 1;
+
+                for (std::size_t i = Hash & Mask; Slots[i]; i = (i + 1) & Mask)
+                {
+                    if (Slots[i]->Hash == Hash && std::string_view{Slots[i]->Data, Slots[i]->Size} == Text)
+                        return Slots[i];
+                }
+
+                return nullptr;
+            }
+
+            Entry const *Intern(std::string_view Text, std::size_t Hash)
+            {
+                if (auto Found = Find(Text, Hash))
+                    return Found;
+
+                if ((Count + 1) * 2 > Slots.size())
+                    Rehash(std::max<std::size_t>(Slots.size() * 2, 64));
+
+                auto Memory = static_cast<char *>(Storage.allocate(sizeof(Entry) + Text.size(), alignof(Entry)));
+                auto Data = Memory + sizeof(Entry);
+
+                std::memcpy(Data, Text.data(), Text.size());
+
+                auto Result = ::new (Memory) Entry{Hash, Text.size(), Data};
+
+                Place(Result);
+                ++Count;
+
+                return Result;
+            }
+
+            std::size_t Size() const
+            {
+                return Count;
+            }
+
+        private:
+            std::pmr::monotonic_buffer_resource Storage;
+            std::pmr::vector<Entry const *> Slots;
+            std::size_t Count = 0;
+
+            void Place(Entry const *Item)
+            {
+                std::size_t Mask = Slots.size() - 1;
+                std::size_t i = Item->Hash & Mask;
+
+                while (Slots[i])
+                    i = (i + 1) & Mask;
+
+                Slots[i] = Item;
+            }
+
+            void Rehash(std::size_t Length)
+            {
+                std::pmr::vector<Entry const *> Previous(Length, nullptr, Slots.get_allocator());
+
+                Previous.swap(Slots);
+
+                for (auto Item : Previous)
+                {
+                    if (Item)
+                        Place(Item);
+                }
+            }
+        };
+
+        // Makes the symbols created on this thread intern into Keys until it is destroyed
+
+        class Session
+        {
+        public:
+            explicit Session(Pool &Keys)
+                : Previous(std::exchange(Current, &Keys))
+            {
+            }
+
+            Session(Session const &) = delete;
+            Session &operator=(Session const &) = delete;
+
+            ~Session()
+            {
+                Current = Previous;
+            }
+
+        private:
+            Pool *Previous;
+        };
+
+        // Lets Escape::Make hand over keys decoded into a temporary, they get copied into the pool
+
+        constexpr static bool Copies = true;
+
+        Symbol()
+            : Symbol(std::string_view{})
+        {
+        }
+
+        Symbol(std::string_view Text)
+            : Item(Intern(Text))
+        {
+        }
+
+        Symbol(char const *Text)
+            : Symbol(std::string_view{Text})
+        {
+        }
+
+        // The symbol of Text in the pool this thread interns into, or a null one when there
+        // is none. Lookups made with it don't grow the pool.
+
+        static Symbol Find(std::string_view Text)
+        {
+            std::size_t Hash = std::hash<std::string_view>{}(Text);
+
+            if (Current)
+                return Symbol(Current->Find(Text, Hash));
+
+            std::shared_lock Reading{Lock()};
+
+            return Symbol(Shared().Find(Text, Hash));
+        }
+
+        bool Null() const
+        {
+            return Item == &Missing;
+        }
+
+        std::string_view View() const
+        {
+            return {Item->Data, Item->Size};
+        }
+
+        operator std::string_view() const
+        {
+            return View();
+        }
+
+        char const *data() const
+        {
+            return Item->Data;
+        }
+
+        std::size_t size() const
+        {
+            return Item->Size;
+        }
+
+        std::size_t Hash() const
+        {
+            return Item->Hash;
+        }
+
+        // Symbols of different pools only compare their text when their hashes match
+
+        bool operator==(Symbol const &Other) const
+        {
+            return Item == Other.Item || (Item->Hash == Other.Item->Hash && View() == Other.View());
+        }
+
+        // Ordered by hash first, so std::map iterates symbols in no particular order
+
+        std::strong_ordering operator<=>(Symbol const &Other) const
+        {
+            if (Item == Other.Item)
+                return std::strong_ordering::equal;
+
+            if (auto Order = Item->Hash <=> Other.Item->Hash; Order != 0)
+                return Order;
+
+            return View() <=> Other.View();
+        }
+
+        template <typename TSerializer>
+        friend TSerializer &operator<<(TSerializer &os, Symbol const &Value)
+        {
+            os << Value.View();
+
+            return os;
+        }
+
+    private:
+        Entry const *Item;
+
+        // Its hash being the one of no empty key, it compares equal to none of them
+
+        inline static Entry const Missing{std::hash<std::string_view>{}({}) + 1, 0, ""};
+
+        explicit Symbol(Entry const *Found)
+            : Item(Found ? Found : &Missing)
+        {
+        }
+
+        // The pool shared by the threads without a session
+
+        static Pool &Shared()
+        {
+            static Pool Instance{std::pmr::new_delete_resource()};
+
+            return Instance;
+        }
+
+        static std::shared_mutex &Lock()
+        {
+            static std::shared_mutex Instance;
+
+            return Instance;
+        }
+
+        inline static thread_local Pool *Current = nullptr;
+
+        static Entry const *Intern(std::string_view Text)
+        {
+            std::size_t Hash = std::hash<std::string_view>{}(Text);
+
+            if (Current)
+                return Current->Intern(Text, Hash);
+
+            {
+                std::shared_lock Reading{Lock()};
+
+                if (auto Found = Shared().Find(Text, Hash))
+                    return Found;
+            }
+
+            std::unique_lock Writing{Lock()};
+
+            return Shared().Intern(Text, Hash);
+        }
+    };
+}
+
+template <>
+struct std::hash<Core::Symbol>
+{
+    std::size_t operator()(Core::Symbol const &Value) const noexcept
+    {
+        return Value.Hash();
+    }
+};
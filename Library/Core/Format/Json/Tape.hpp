@@ -0,0 +1,636 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <memory_resource>
+
+#include "Sax.hpp"
+
+// Compact alternative to the Recursive tree. The whole document is kept in a single array of
+// 64 bit words, each one starting with a tag in its top byte followed by a 56 bit payload:
+//
+//     '{' '['    Number of children in bits 32 to 55, index of the word following the
+//                matching close word in the lower 32 bits
+//     '}' ']'    Index of the matching open word
+//     '"'        Offset of the content in the input, or in the decoded strings of the tape
+//                when bit 55 is set, the next word holds its length
+//     'l' 'd'    The next word holds the bits of the std::int64_t or the double
+//     't' 'f' 'n'
+//
+// Object members are stored as their key string followed by the value. Strings are not
+// copied so the input has to outlive the tape, only the ones holding escapes are decoded
+// into a buffer of the tape. Values are
+// read through views that only hold the tape and the index of their first word, skipping a
+// container is a single jump to the word following it.
+
+namespace Core
+{
+    class Tape
+    {
+    public:
+        class Value;
+        class Object;
+        class Array;
+
+        // Sax handler appending to a tape. Strings and keys have to be views into the source
+        // of the tape, which rules out the chunked parser.
+
+        class Builder
+        {
+        public:
+            constexpr static bool Decode = false;
+
+            explicit Builder(Tape &Target)
+                : Words(Target.Words), Open(Target.Words.get_allocator().resource()), Source(Target.Source), Decoded(Target.Decoded)
+            {
+            }
+
+            void StartObject()
+            {
+                Start('{');
+            }
+
+            void StartArray()
+            {
+                Start('[');
+            }
+
+            void EndObject()
+            {
+                End();
+            }
+
+            void EndArray()
+            {
+                End();
+            }
+
+            bool Key(std::string_view Raw, bool Escaped)
+            {
+                if (!Open.empty())
+                    Open.back().Key = Words.size();
+
+                return Text(Raw, Escaped);
+            }
+
+            bool String(std::string_view Raw, bool Escaped)
+            {
+                if (!Text(Raw, Escaped))
+                    return false;
+
+                Count();
+
+                return true;
+            }
+
+            void Integer(std::int64_t Value)
+            {
+                Count();
+                Push('l', 0);
+                Words.push_back(std::bit_cast<std::uint64_t>(Value));
+            }
+
+            void Double(double Value)
+            {
+                Count();
+                Push('d', 0);
+                Words.push_back(std::bit_cast<std::uint64_t>(Value));
+            }
+
+            void Boolean(bool Value)
+            {
+                Count();
+                Push(Value ? 't' : 'f', 0);
+            }
+
+            void Null()
+            {
+                Count();
+                Push('n', 0);
+            }
+
+            // Closes the containers left open by malformed input, dropping a key whose value
+            // never came. An empty tape gets a null.
+
+            void Finish()
+            {
+                while (!Open.empty())
+                    End();
+
+                if (Words.empty())
+                    Push('n', 0);
+            }
+
+        private:
+            struct Frame
+            {
+                std::size_t Index;
+                std::size_t Children;
+
+                // Index of the last key while its value is missing
+
+                std::size_t Key = None;
+            };
+
+            constexpr static std::size_t None = std::size_t(-1);
+
+            std::pmr::vector<std::uint64_t> &Words;
+            std::pmr::vector<Frame> Open;
+            std::string_view Source;
+            std::pmr::string &Decoded;
+
+            void Push(char Tag, std::uint64_t Payload)
+            {
+                Words.push_back(Word(Tag, Payload));
+            }
+
+            void Count()
+            {
+                if (!Open.empty())
+                {
+                    ++Open.back().Children;
+                    Open.back().Key = None;
+                }
+            }
+
+            void Start(char Tag)
+            {
+                Count();
+                Open.push_back({Words.size(), 0});
+                Push(Tag, 0);
+            }
+
+            void End()
+            {
+                auto Top = Open.back();
+
+                Open.pop_back();
+
+                if (Top.Key != None)
+                    Words.resize(Top.Key);
+
+                char Tag = static_cast<char>(Words[Top.Index] >> 56);
+
+                Words[Top.Index] = Word(Tag, std::min<std::uint64_t>(Top.Children, MaxCount) << 32 | (Words.size() + 1));
+                Push(Tag == '{' ? '}' : ']', Top.Index);
+            }
+
+            bool Text(std::string_view Raw, bool Escaped)
+            {
+                if (!Escaped)
+                {
+                    Push('"', Raw.data() - Source.data());
+                    Words.push_back(Raw.size());
+
+                    return true;
+                }
+
+                std::size_t Offset = Decoded.size();
+
+                Decoded.resize(Offset + Raw.size());
+
+                auto Size = Escape::Decode(Raw, Decoded.data() + Offset);
+
+                if (Size == Escape::Invalid)
+                    return false;
+
+                Decoded.resize(Offset + Size);
+
+                Push('"', InDecoded | Offset);
+                Words.push_back(Size);
+
+                return true;
+            }
+        };
+
+        Tape() = default;
+
+        explicit Tape(std::pmr::memory_resource *Resource)
+            : Words(Resource), Decoded(Resource)
+        {
+        }
+
+        // Parses sv, which has to outlive the tape. Malformed input keeps what was parsed
+        // before the error, as Json::From does.
+
+        static Tape From(std::string_view sv, std::pmr::memory_resource *Resource = std::pmr::get_default_resource())
+        {
+            Tape Result{Resource};
+
+            Structural::Index Positions{sv};
+            Structural::Cursor Cursor{Positions};
+
+            // About one word per structural position, numbers take two but are followed by a separator
+
+            Result.Source = sv;
+            Result.Words.reserve(Positions.Size() + 1);
+
+            Builder Handler{Result};
+
+            Sax::Value(Cursor, Handler);
+            Handler.Finish();
+
+            return Result;
+        }
+
+        inline Value Root() const;
+
+        inline Value operator[](std::string_view Key) const;
+
+        inline Value operator[](std::size_t Index) const;
+
+        std::string_view GetSource() const
+        {
+            return Source;
+        }
+
+        auto const &GetWords() const
+        {
+            return Words;
+        }
+
+    private:
+        // Children counts above this are found by walking the container
+
+        constexpr static std::uint64_t MaxCount = (std::uint64_t{1} << 24) - 1;
+
+        // Strings with escapes are stored decoded here, their payload flagged with InDecoded
+
+        constexpr static std::uint64_t InDecoded = std::uint64_t{1} << 55;
+
+        std::pmr::vector<std::uint64_t> Words;
+        std::pmr::string Decoded;
+        std::string_view Source;
+
+        constexpr static std::uint64_t Word(char Tag, std::uint64_t Payload)
+        {
+            return std::uint64_t(static_cast<unsigned char>(Tag)) << 56 | Payload;
+        }
+
+        char Tag(std::size_t Index) const
+        {
+            return static_cast<char>(Words[Index] >> 56);
+        }
+
+        std::uint64_t Payload(std::size_t Index) const
+        {
+            return Words[Index] & ((std::uint64_t{1} << 56) - 1);
+        }
+
+        std::string_view Text(std::size_t Index) const
+        {
+            if (auto Offset = Payload(Index); Offset & InDecoded)
+                return std::string_view{Decoded}.substr(Offset & ~InDecoded, Words[Index + 1]);
+            else
+                return Source.substr(Offset, Words[Index + 1]);
+        }
+
+        // Index of the word following the value starting at Index
+
+        std::size_t Skip(std::size_t Index) const
+        {
+            switch (Tag(Index))
+            {
+            case '{':
+            case '[':
+                return Payload(Index) & 0xFFFFFFFF;
+            case '"':
+            case 'l':
+            case 'd':
+                return Index + 2;
+            default:
+                return Index + 1;
+            }
+        }
+
+        std::size_t Children(std::size_t Index, std::size_t Step) const
+        {
+            if (std::size_t Count = Payload(Index) >> 32; Count < MaxCount)
+                return Count;
+
+            std::size_t Count = 0;
+
+            for (std::size_t i = Index + 1, End = Skip(Index) - 1; i != End; i = Skip(i + Step))
+                ++Count;
+
+            return Count;
+        }
+
+    public:
+        class Value
+        {
+        public:
+            Value(Tape const &Owner, std::size_t Index)
+                : Owner(&Owner), Position(Index)
+            {
+            }
+
+            template <typename Target>
+            bool Is() const
+            {
+                static_assert(Alternative<Target>, "Tape values hold no such type");
+
+                char Tag = Owner->Tag(Position);
+
+                if constexpr (std::is_same_v<Target, Object>)
+                    return Tag == '{';
+                else if constexpr (std::is_same_v<Target, Array>)
+                    return Tag == '[';
+                else if constexpr (std::is_same_v<Target, std::string_view>)
+                    return Tag == '"';
+                else if constexpr (std::is_same_v<Target, std::int64_t>)
+                    return Tag == 'l';
+                else if constexpr (std::is_same_v<Target, double>)
+                    return Tag == 'd';
+                else if constexpr (std::is_same_v<Target, bool>)
+                    return Tag == 't' || Tag == 'f';
+                else
+                    return Tag == 'n';
+            }
+
+            template <typename Target>
+            Target As() const
+            {
+                if (!Is<Target>())
+                    throw std::invalid_argument("Value holds another type");
+
+                if constexpr (std::is_same_v<Target, Object> || std::is_same_v<Target, Array>)
+                    return Target{*Owner, Position};
+                else if constexpr (std::is_same_v<Target, std::string_view>)
+                    return Owner->Text(Position);
+                else if constexpr (std::is_same_v<Target, std::int64_t> || std::is_same_v<Target, double>)
+                    return std::bit_cast<Target>(Owner->Words[Position + 1]);
+                else if constexpr (std::is_same_v<Target, bool>)
+                    return Owner->Tag(Position) == 't';
+                else
+                    return nullptr;
+            }
+
+            Value operator[](std::string_view Key) const
+            {
+                if (!Is<Object>())
+                    throw std::invalid_argument("Object is not json");
+
+                return Object{*Owner, Position}[Key];
+            }
+
+            Value operator[](std::size_t Index) const
+            {
+                if (!Is<Array>())
+                    throw std::invalid_argument("Object is not array");
+
+                return Array{*Owner, Position}[Index];
+            }
+
+            // Calls Visitor with the Object, Array, std::string_view, std::int64_t, double,
+            // bool or std::nullptr_t held by the value
+
+            template <typename TVisitor>
+            decltype(auto) Visit(TVisitor &&Visitor) const
+            {
+                switch (Owner->Tag(Position))
+                {
+                case '{':
+                    return Visitor(As<Object>());
+                case '[':
+                    return Visitor(As<Array>());
+                case '"':
+                    return Visitor(As<std::string_view>());
+                case 'l':
+                    return Visitor(As<std::int64_t>());
+                case 'd':
+                    return Visitor(As<double>());
+                case 't':
+                case 'f':
+                    return Visitor(As<bool>());
+                default:
+                    return Visitor(nullptr);
+                }
+            }
+
+            template <typename TSerializer>
+            friend TSerializer &operator<<(TSerializer &os, Value const &value)
+            {
+                value.Visit(
+                    [&](auto &&arg)
+                    {
+                        using TArg = std::decay_t<decltype(arg)>;
+
+                        if constexpr (std::is_same_v<TArg, Object>)
+                        {
+                            os << '{';
+
+                            bool First = true;
+
+                            for (auto [Key, Member] : arg)
+                            {
+                                os << (First ? "\"" : ",\"");
+
+                                Escape::Encode(Key, [&](std::string_view Piece)
+                                               { os << Piece; });
+
+                                os << "\":" << Member;
+                                First = false;
+                            }
+
+                            os << '}';
+                        }
+                        else if constexpr (std::is_same_v<TArg, Array>)
+                        {
+                            os << '[';
+
+                            bool First = true;
+
+                            for (auto Item : arg)
+                            {
+                                if (!First)
+                                    os << ',';
+
+                                os << Item;
+                                First = false;
+                            }
+
+                            os << ']';
+                        }
+                        else if constexpr (std::is_same_v<TArg, std::string_view>)
+                        {
+                            os << '"';
+
+                            Escape::Encode(arg, [&](std::string_view Piece)
+                                           { os << Piece; });
+
+                            os << '"';
+                        }
+                        else if constexpr (std::is_same_v<TArg, bool>)
+                            os << (arg ? "true" : "false");
+                        else if constexpr (std::is_same_v<TArg, std::nullptr_t>)
+                            os << "null";
+                        else
+                            os << arg;
+                    });
+
+                return os;
+            }
+
+        private:
+            template <typename Target>
+            constexpr static bool Alternative = std::is_same_v<Target, Object> || std::is_same_v<Target, Array> ||
+                                                std::is_same_v<Target, std::string_view> || std::is_same_v<Target, std::int64_t> ||
+                                                std::is_same_v<Target, double> || std::is_same_v<Target, bool> ||
+                                                std::is_same_v<Target, std::nullptr_t>;
+
+            Tape const *Owner;
+            std::size_t Position;
+        };
+
+        // Walks the children of a container, Step being the number of words preceding each
+        // value (the key of object members)
+
+        template <typename TItem, std::size_t Step>
+        class Iterator
+        {
+        public:
+            Iterator(Tape const &Owner, std::size_t Index)
+                : Owner(&Owner), Position(Index)
+            {
+            }
+
+            TItem operator*() const
+            {
+                if constexpr (Step)
+                    return {Owner->Text(Position), Value{*Owner, Position + Step}};
+                else
+                    return Value{*Owner, Position};
+            }
+
+            Iterator &operator++()
+            {
+                Position = Owner->Skip(Position + Step);
+
+                return *this;
+            }
+
+            bool operator==(Iterator const &Other) const
+            {
+                return Position == Other.Position;
+            }
+
+        private:
+            Tape const *Owner;
+            std::size_t Position;
+        };
+
+        class Object
+        {
+        public:
+            using Member = std::pair<std::string_view, Value>;
+
+            Object(Tape const &Owner, std::size_t Index)
+                : Owner(&Owner), Position(Index)
+            {
+            }
+
+            Iterator<Member, 2> begin() const
+            {
+                return {*Owner, Position + 1};
+            }
+
+            Iterator<Member, 2> end() const
+            {
+                return {*Owner, Owner->Skip(Position) - 1};
+            }
+
+            std::size_t Size() const
+            {
+                return Owner->Children(Position, 2);
+            }
+
+            bool Empty() const
+            {
+                return Owner->Skip(Position) == Position + 2;
+            }
+
+            // First member named Key, keys are compared as they appear in the input
+
+            Value operator[](std::string_view Key) const
+            {
+                for (auto [Name, Member] : *this)
+                {
+                    if (Name == Key)
+                        return Member;
+                }
+
+                throw std::out_of_range("No such key");
+            }
+
+        private:
+            Tape const *Owner;
+            std::size_t Position;
+        };
+
+        class Array
+        {
+        public:
+            Array(Tape const &Owner, std::size_t Index)
+                : Owner(&Owner), Position(Index)
+            {
+            }
+
+            Iterator<Value, 0> begin() const
+            {
+                return {*Owner, Position + 1};
+            }
+
+            Iterator<Value, 0> end() const
+            {
+                return {*Owner, Owner->Skip(Position) - 1};
+            }
+
+            std::size_t Size() const
+            {
+                return Owner->Children(Position, 0);
+            }
+
+            bool Empty() const
+            {
+                return Owner->Skip(Position) == Position + 2;
+            }
+
+            Value operator[](std::size_t Index) const
+            {
+                for (auto Item : *this)
+                {
+                    if (!Index--)
+                        return Item;
+                }
+
+                throw std::out_of_range("Index out of range");
+            }
+
+        private:
+            Tape const *Owner;
+            std::size_t Position;
+        };
+    };
+
+    inline Tape::Value Tape::Root() const
+    {
+        return {*this, 0};
+    }
+
+    inline Tape::Value Tape::operator[](std::string_view Key) const
+    {
+        return Root()[Key];
+    }
+
+    inline Tape::Value Tape::operator[](std::size_t Index) const
+    {
+        return Root()[Index];
+    }
+}
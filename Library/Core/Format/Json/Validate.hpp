@@ -0,0 +1,319 @@
+#pragma once
+
+#include <bit>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "Sax.hpp"
+#include "Escape.hpp"
+#include "Number.hpp"
+#include "Result.hpp"
+#include "Structural.hpp"
+
+// Checks that a document is valid Json (RFC 8259) without building anything nor allocating.
+// The input is classified 64 bytes at a time as for the structural index, but the positions
+// of a block are kept on the stack and checked against the grammar before moving on to the
+// next block, so the input is read once. Control characters in strings are found from the
+// block masks, strings holding escapes or bytes outside of ASCII are checked on their own
+// once closed, the same way the parser does.
+//
+// Numbers are checked against the grammar only, their magnitude is not limited. Limits bound
+// the size of the input, the nesting, up to Sax::MaxDepth, and the size of strings and keys
+// as they appear in the input.
+
+namespace Core
+{
+    struct Limits
+    {
+        std::size_t Bytes = std::numeric_limits<std::size_t>::max();
+        std::size_t Depth = Sax::MaxDepth;
+        std::size_t String = std::numeric_limits<std::size_t>::max();
+    };
+
+    class Validator
+    {
+    public:
+        explicit Validator(std::string_view Source, Limits Bounds = {})
+            : Source(Source), Bounds(Bounds)
+        {
+        }
+
+        Status Run(Structural::Level Use = Structural::Detect())
+        {
+            if (Source.size() > Bounds.Bytes)
+                return {Error::Size, Bounds.Bytes};
+
+            std::uint64_t EscapeCarry = 0;
+            std::uint64_t StringCarry = 0;
+            std::uint64_t ScalarCarry = 0;
+
+            for (std::size_t Offset = 0; Offset < Source.size(); Offset += 64)
+            {
+                char Padded[64];
+                char const *Data = Source.data() + Offset;
+
+                if (Source.size() - Offset < 64)
+                {
+                    std::memset(Padded, ' ', 64);
+                    std::memcpy(Padded, Data, Source.size() - Offset);
+                    Data = Padded;
+                }
+
+                Structural::Block Masks = Structural::Classify(Data, Use);
+
+                std::uint64_t Quote = Masks.Quote & ~Structural::Escaped(Masks.Backslash, EscapeCarry);
+                std::uint64_t InString = Structural::PrefixXor(Quote) ^ StringCarry;
+                StringCarry = std::uint64_t(std::int64_t(InString) >> 63);
+
+                std::uint64_t Scalar = ~(Masks.Operator | Masks.Space | Quote);
+                std::uint64_t ScalarStart = Scalar & ~(Scalar << 1 | ScalarCarry);
+                ScalarCarry = Scalar >> 63;
+
+                // Bytes needing a closer look are only remembered, strings are checked once
+                // closed. The first control character within a string ends the checks.
+
+                std::uint64_t Control = Masks.Control & InString;
+                std::uint64_t Bits = ((Masks.Operator | ScalarStart) & ~InString) | Quote;
+
+                if (Control)
+                    Bits &= (std::uint64_t{1} << std::countr_zero(Control)) - 1;
+
+                Block = Offset;
+                BlockBackslash = Masks.Backslash & InString;
+                BlockHigh = Masks.High & InString;
+
+                while (Bits)
+                {
+                    if (!Step(Offset + std::countr_zero(Bits)))
+                        return Failure;
+
+                    Bits &= Bits - 1;
+                }
+
+                if (Control)
+                    return {Error::String, Offset + std::countr_zero(Control)};
+
+                Backslash = Last(BlockBackslash, Offset, Backslash);
+                High = Last(BlockHigh, Offset, High);
+            }
+
+            return Finish();
+        }
+
+    private:
+        enum class State : std::uint8_t
+        {
+            Value,
+            FirstValue,
+            Key,
+            FirstKey,
+            Colon,
+            Close
+        };
+
+        std::string_view Source;
+        Limits Bounds;
+        Status Failure;
+
+        Sax::Stack Levels;
+        State Next = State::Value;
+
+        // Start of the string or scalar being read, npos when none
+
+        std::size_t String = std::string_view::npos;
+        std::size_t Token = std::string_view::npos;
+        bool Key = false;
+
+        // Last backslash and byte outside of ASCII within a string in the blocks before the
+        // current one, and their masks in the current one
+
+        std::size_t Backslash = std::string_view::npos;
+        std::size_t High = std::string_view::npos;
+        std::size_t Block = 0;
+        std::uint64_t BlockBackslash = 0;
+        std::uint64_t BlockHigh = 0;
+
+        static std::size_t Last(std::uint64_t Bits, std::size_t Offset, std::size_t Previous)
+        {
+            return Bits ? Offset + 63 - std::countl_zero(Bits) : Previous;
+        }
+
+        bool Fail(Error Code, std::size_t Offset)
+        {
+            Failure = {Code, Offset};
+
+            return false;
+        }
+
+        // Whether the last byte of Bits before To, or else Before, comes after From. To is in
+        // the current block.
+
+        bool Between(std::uint64_t Bits, std::size_t Before, std::size_t From, std::size_t To) const
+        {
+            std::uint64_t Below = Bits & ((std::uint64_t{1} << (To - Block)) - 1);
+            std::size_t Found = Below ? Block + 63 - std::countl_zero(Below) : Before;
+
+            return Found != std::string_view::npos && Found > From;
+        }
+
+        bool Scalar(std::size_t End)
+        {
+            std::size_t Stop = End;
+
+            while (Stop > Token && Structural::IsWhiteSpace(Source[Stop - 1]))
+                --Stop;
+
+            auto Text = Source.substr(Token, Stop - Token);
+            std::int64_t Integer;
+
+            if (Text != "true" && Text != "false" && Text != "null" && Core::Number::Scan(Text, Integer) == Core::Number::Kind::Invalid)
+                return Fail(Error::Number, Token);
+
+            Token = std::string_view::npos;
+            Next = State::Close;
+
+            return true;
+        }
+
+        bool Close(std::size_t End)
+        {
+            std::size_t Start = String;
+
+            String = std::string_view::npos;
+
+            if (End - Start - 1 > Bounds.String)
+                return Fail(Error::Size, Start);
+
+            auto Raw = Source.substr(Start + 1, End - Start - 1);
+
+            if (Between(BlockBackslash, Backslash, Start, End) && Escape::Decode<false>(Raw, nullptr) == Escape::Invalid)
+                return Fail(Error::String, Start);
+
+            if (Between(BlockHigh, High, Start, End) && !Escape::Utf8(Raw))
+                return Fail(Error::String, Start);
+
+            Next = Key ? State::Colon : State::Close;
+
+            return true;
+        }
+
+        bool Open(bool Object, std::size_t Offset)
+        {
+            if (Levels.Size() == Bounds.Depth || !Levels.Push(Object))
+                return Fail(Error::Depth, Offset);
+
+            Next = Object ? State::FirstKey : State::FirstValue;
+
+            return true;
+        }
+
+        bool Value(char c, std::size_t Offset)
+        {
+            if (c == '{' || c == '[')
+                return Open(c == '{', Offset);
+
+            if (c == '"')
+            {
+                String = Offset;
+                Key = false;
+
+                return true;
+            }
+
+            if (Structural::IsOperator(c))
+                return Fail(Error::Syntax, Offset);
+
+            Token = Offset;
+
+            return true;
+        }
+
+        bool Step(std::size_t Offset)
+        {
+            char c = Source[Offset];
+
+            if (String != std::string_view::npos)
+                return Close(Offset);
+
+            if (Token != std::string_view::npos && !Scalar(Offset))
+                return false;
+
+            switch (Next)
+            {
+            case State::FirstValue:
+                if (c == ']')
+                    return Pop();
+
+                [[fallthrough]];
+            case State::Value:
+                return Value(c, Offset);
+            case State::FirstKey:
+                if (c == '}')
+                    return Pop();
+
+                [[fallthrough]];
+            case State::Key:
+                if (c != '"')
+                    return Fail(Error::Syntax, Offset);
+
+                String = Offset;
+                Key = true;
+
+                return true;
+            case State::Colon:
+                if (c != ':')
+                    return Fail(Error::Syntax, Offset);
+
+                Next = State::Value;
+
+                return true;
+            case State::Close:
+                if (Levels.Empty())
+                    return Fail(Error::Trailing, Offset);
+
+                if (c == ',')
+                {
+                    Next = Levels.InObject() ? State::Key : State::Value;
+
+                    return true;
+                }
+
+                if ((c == '}' && Levels.InObject()) || (c == ']' && !Levels.InObject()))
+                    return Pop();
+
+                return Fail(Error::Syntax, Offset);
+            }
+
+            return Fail(Error::Syntax, Offset);
+        }
+
+        bool Pop()
+        {
+            Levels.Pop();
+            Next = State::Close;
+
+            return true;
+        }
+
+        Status Finish()
+        {
+            if (String != std::string_view::npos)
+                return {Error::Syntax, Source.size()};
+
+            if (Token != std::string_view::npos && !Scalar(Source.size()))
+                return Failure;
+
+            if (Next != State::Close || !Levels.Empty())
+                return {Error::Syntax, Source.size()};
+
+            return {};
+        }
+    };
+
+    inline Status Validate(std::string_view sv, Limits Bounds = {})
+    {
+        return Validator{sv, Bounds}.Run();
+    }
+}
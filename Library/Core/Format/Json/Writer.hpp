@@ -0,0 +1,396 @@
+#pragma once
+
+#include <cmath>
+#include <string>
+#include <cstring>
+#include <charconv>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+
+#include "Escape.hpp"
+#include "Number.hpp"
+#include "Describe.hpp"
+
+// Serializer writing into a fixed staging buffer which is handed to a sink whenever it fills
+// up, instead of going through an ostream one character at a time. Numbers are formatted with
+// std::to_chars and strings are escaped through Escape::Encode. A sink is either a string like
+// type with append(char const *, std::size_t) or any callable taking a std::string_view.
+//
+// Values are written through their members rather than their types, so any of the strategies
+// works as well as the Tape views : objects expose GetMap() or iterate over key / value pairs,
+// arrays are other ranges and variants are unwrapped through Visit. Described types are
+// written as objects, empty std::optional as null and Core::Number as its text.
+
+namespace Core
+{
+    struct Format
+    {
+        bool Pretty = false;
+        std::size_t Indent = 4;
+    };
+
+    template <typename TSink>
+    class Writer
+    {
+    public:
+        explicit Writer(TSink &Sink, Format Options = {})
+            : Sink(Sink), Options(Options)
+        {
+        }
+
+        Writer(Writer const &) = delete;
+        Writer &operator=(Writer const &) = delete;
+
+        ~Writer()
+        {
+            Flush();
+        }
+
+        template <typename TValue>
+        Writer &Write(TValue const &Value)
+        {
+            if constexpr (Described<TValue>)
+            {
+                Fields(Value);
+            }
+            else if constexpr (requires { Value.has_value(); *Value; })
+            {
+                if (Value.has_value())
+                    Write(*Value);
+                else
+                    Put("null");
+            }
+            else if constexpr (requires { Value.GetMap(); })
+            {
+                Object(Value.GetMap());
+            }
+            else if constexpr (requires { Value.Visit([](auto const &) {}); })
+            {
+                Value.Visit([&](auto const &Item)
+                            { Write(Item); });
+            }
+            else if constexpr (std::is_same_v<TValue, Core::Number>)
+            {
+                Put(Value.GetRaw());
+            }
+            else if constexpr (std::is_same_v<TValue, bool>)
+            {
+                Put(Value ? std::string_view{"true"} : std::string_view{"false"});
+            }
+            else if constexpr (std::is_same_v<TValue, std::nullptr_t>)
+            {
+                Put("null");
+            }
+            else if constexpr (std::is_integral_v<TValue> || std::is_floating_point_v<TValue>)
+            {
+                Number(Value);
+            }
+            else if constexpr (std::is_constructible_v<std::string_view, TValue const &>)
+            {
+                String(Value);
+            }
+            else if constexpr (requires { (*std::begin(Value)).first; (*std::begin(Value)).second; })
+            {
+                Object(Value);
+            }
+            else
+            {
+                static_assert(requires { std::begin(Value); std::end(Value); }, "Value can not be serialized");
+
+                Array(Value);
+            }
+
+            return *this;
+        }
+
+        // Hands whatever is staged over to the sink
+
+        void Flush()
+        {
+            if (Used)
+            {
+                Emit({Staging, Used});
+                Used = 0;
+            }
+        }
+
+    private:
+        constexpr static std::size_t Capacity = 4096;
+
+        TSink &Sink;
+        Format Options;
+
+        std::size_t Depth = 0;
+        std::size_t Used = 0;
+        char Staging[Capacity];
+
+        void Emit(std::string_view Piece)
+        {
+            if constexpr (requires { Sink.append(Piece.data(), Piece.size()); })
+                Sink.append(Piece.data(), Piece.size());
+            else
+                Sink(Piece);
+        }
+
+        void Put(char c)
+        {
+            if (Used == Capacity)
+                Flush();
+
+            Staging[Used++] = c;
+        }
+
+        void Put(std::string_view Piece)
+        {
+            if (Piece.size() > Capacity - Used)
+            {
+                Flush();
+
+                if (Piece.size() > Capacity)
+                    return Emit(Piece);
+            }
+
+            std::memcpy(Staging + Used, Piece.data(), Piece.size());
+            Used += Piece.size();
+        }
+
+        template <typename TNumber>
+        void Number(TNumber Value)
+        {
+            // Json has no representation for infinities and NaN
+
+            if constexpr (std::is_floating_point_v<TNumber>)
+            {
+                if (!std::isfinite(Value))
+                    return Put("null");
+            }
+
+            char Digits[32];
+
+            auto [Pointer, Error] = std::to_chars(Digits, Digits + sizeof(Digits), Value);
+
+            Put({Digits, static_cast<std::size_t>(Pointer - Digits)});
+        }
+
+        void String(std::string_view Value)
+        {
+            Put('"');
+
+            Escape::Encode(Value, [&](std::string_view Piece)
+                           { Put(Piece); });
+
+            Put('"');
+        }
+
+        void Line()
+        {
+            if (!Options.Pretty)
+                return;
+
+            Put('\n');
+
+            for (std::size_t i = 0; i < Depth * Options.Indent; ++i)
+                Put(' ');
+        }
+
+        template <typename TItems, typename TEach>
+        void Container(TItems const &Items, char Open, char Close, TEach &&Each)
+        {
+            Put(Open);
+
+            auto Begin = std::begin(Items), End = std::end(Items);
+
+            if (Begin == End)
+                return Put(Close);
+
+            ++Depth;
+
+            for (auto i = Begin; i != End; ++i)
+            {
+                if (i != Begin)
+                    Put(',');
+
+                Line();
+                Each(*i);
+            }
+
+            --Depth;
+
+            Line();
+            Put(Close);
+        }
+
+        template <typename TMap>
+        void Object(TMap const &Members)
+        {
+            Container(Members, '{', '}', [&](auto const &Member)
+                      {
+                          String(Member.first);
+                          Put(Options.Pretty ? std::string_view{": "} : std::string_view{":"});
+                          Write(Member.second); });
+        }
+
+        template <typename TStruct>
+        void Fields(TStruct const &Value)
+        {
+            Put('{');
+
+            bool First = true;
+
+            ++Depth;
+
+            Members(Value, [&](std::string_view Name, auto const &Member)
+                    {
+                        if (!First)
+                            Put(',');
+
+                        Line();
+                        String(Name);
+                        Put(Options.Pretty ? std::string_view{": "} : std::string_view{":"});
+                        Write(Member);
+
+                        First = false; });
+
+            --Depth;
+
+            if (!First)
+                Line();
+
+            Put('}');
+        }
+
+        template <typename TArray>
+        void Array(TArray const &Items)
+        {
+            Container(Items, '[', ']', [&](auto const &Item)
+                      { Write(Item); });
+        }
+    };
+
+    // Upper bound of the serialized size of Value, exact except for floating point numbers
+    // which count for the longest representation std::to_chars may produce
+
+    template <typename TValue>
+    std::size_t Estimate(TValue const &Value, Format Options = {}, std::size_t Depth = 0)
+    {
+        // Brackets and separators, plus a line and its indentation per item and for the closing character
+
+        auto Enclose = [&](std::size_t Count, std::size_t Size)
+        {
+            Size += 2 + (Count ? Count - 1 : 0);
+
+            if (Options.Pretty && Count)
+                Size += Count * (1 + (Depth + 1) * Options.Indent) + 1 + Depth * Options.Indent;
+
+            return Size;
+        };
+
+        auto Container = [&](auto const &Items, auto &&Each)
+        {
+            std::size_t Count = 0, Size = 0;
+
+            for (auto const &Item : Items)
+            {
+                Size += Each(Item);
+                ++Count;
+            }
+
+            return Enclose(Count, Size);
+        };
+
+        auto Member = [&](std::string_view Name, auto const &Item)
+        {
+            return Escape::Measure(Name) + (Options.Pretty ? 4 : 3) + Estimate(Item, Options, Depth + 1);
+        };
+
+        if constexpr (Described<TValue>)
+        {
+            std::size_t Count = 0, Size = 0;
+
+            Members(Value, [&](std::string_view Name, auto const &Field)
+                    {
+                        Size += Member(Name, Field);
+                        ++Count; });
+
+            return Enclose(Count, Size);
+        }
+        else if constexpr (requires { Value.has_value(); *Value; })
+        {
+            return Value.has_value() ? Estimate(*Value, Options, Depth) : 4;
+        }
+        else if constexpr (requires { Value.GetMap(); })
+        {
+            return Container(Value.GetMap(), [&](auto const &Pair)
+                             { return Member(Pair.first, Pair.second); });
+        }
+        else if constexpr (requires { Value.Visit([](auto const &) {}); })
+        {
+            return Value.Visit([&](auto const &Item)
+                               { return Estimate(Item, Options, Depth); });
+        }
+        else if constexpr (std::is_same_v<TValue, Core::Number>)
+        {
+            return Value.GetRaw().size();
+        }
+        else if constexpr (std::is_same_v<TValue, bool>)
+        {
+            return Value ? 4 : 5;
+        }
+        else if constexpr (std::is_same_v<TValue, std::nullptr_t>)
+        {
+            return 4;
+        }
+        else if constexpr (std::is_integral_v<TValue>)
+        {
+            std::size_t Size = Value < 0 ? 2 : 1;
+
+            for (auto Rest = Value / 10; Rest; Rest /= 10)
+                ++Size;
+
+            return Size;
+        }
+        else if constexpr (std::is_floating_point_v<TValue>)
+        {
+            return 24;
+        }
+        else if constexpr (std::is_constructible_v<std::string_view, TValue const &>)
+        {
+            return Escape::Measure(Value) + 2;
+        }
+        else if constexpr (requires { (*std::begin(Value)).first; (*std::begin(Value)).second; })
+        {
+            return Container(Value, [&](auto const &Pair)
+                             { return Member(Pair.first, Pair.second); });
+        }
+        else
+        {
+            return Container(Value, [&](auto const &Item)
+                             { return Estimate(Item, Options, Depth + 1); });
+        }
+    }
+
+    // Serializes Value into a sink, see Writer for what a sink can be
+
+    template <typename TValue, typename TSink>
+        requires(!std::is_same_v<std::decay_t<TSink>, Format>)
+    void Serialize(TValue const &Value, TSink &&Sink, Format Options = {})
+    {
+        Writer<std::remove_reference_t<TSink>>{Sink, Options}.Write(Value);
+    }
+
+    // Serializes Value into a string allocated once from the estimated size
+
+    template <typename TValue>
+    std::string Serialize(TValue const &Value, Format Options = {})
+    {
+        std::string Result;
+
+        Result.reserve(Estimate(Value, Options));
+
+        Serialize(Value, Result, Options);
+
+        return Result;
+    }
+}